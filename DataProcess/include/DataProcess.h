@@ -87,6 +87,18 @@ public:
      */
     CurveCollection readIgesCurves(const std::string& igesFilePath, double tolerance = 0.1);
     
+    /**
+     * @brief Enable or disable parallel transfer of STEP roots
+     * @param enable Whether independent roots are transferred on worker threads (default: false)
+     */
+    void setParallelTransfer(bool enable);
+    
+    /**
+     * @brief Check whether parallel transfer of STEP roots is enabled
+     * @return true if parallel transfer is enabled
+     */
+    bool isParallelTransfer() const;
+    
 private:
     /**
      * @brief Set the last error message
@@ -95,4 +107,5 @@ private:
     void setLastError(const std::string& errorMessage);
     
     std::string m_lastError;
+    bool m_parallelTransfer;
 };
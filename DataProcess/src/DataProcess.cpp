@@ -1,4 +1,5 @@
 #include "DataProcess.h"
+#include "ParallelStepTransfer.h"
 
 // OCCT headers for STEP import
 #include <STEPControl_Reader.hxx>
@@ -18,7 +19,20 @@
 #include <GCPnts_TangentialDeflection.hxx>
 #include <gp_Pnt.hxx>
 
+namespace
+{
+    // Transfer all roots of a read STEP file, on worker threads if requested
+    TopoDS_Shape transferStepRoots(STEPControl_Reader& reader, bool parallel, int& nbRoots)
+    {
+        ParallelStepTransfer transfer(reader);
+        transfer.SetParallel(parallel);
+        nbRoots = transfer.Perform();
+        return transfer.OneShape();
+    }
+}
+
 DataProcess::DataProcess()
+    : m_parallelTransfer(false)
 {
     // Initialize OCCT if needed
 }
@@ -37,7 +51,6 @@ bool DataProcess::convertSTEPToSTL(const std::string& stepFilePath,
     {
         // Create STEP reader
         STEPControl_Reader reader;
-        Message_ProgressRange emptyProgress;
         
         // Read STEP file
         IFSelect_ReturnStatus status = reader.ReadFile(stepFilePath.c_str());
@@ -47,16 +60,15 @@ bool DataProcess::convertSTEPToSTL(const std::string& stepFilePath,
             return false;
         }
         
-        // Transfer roots
-        int nbRoots = reader.TransferRoots(emptyProgress);
+        // Transfer roots and get the shape
+        int nbRoots = 0;
+        TopoDS_Shape shape = transferStepRoots(reader, m_parallelTransfer, nbRoots);
         if (nbRoots == 0)
         {
             setLastError("No shapes found in STEP file: " + stepFilePath);
             return false;
         }
         
-        // Get the shape
-        TopoDS_Shape shape = reader.OneShape();
         if (shape.IsNull())
         {
             setLastError("Failed to get shape from STEP file: " + stepFilePath);
@@ -181,6 +193,16 @@ std::string DataProcess::getLastError() const
     return m_lastError;
 }
 
+void DataProcess::setParallelTransfer(bool enable)
+{
+    m_parallelTransfer = enable;
+}
+
+bool DataProcess::isParallelTransfer() const
+{
+    return m_parallelTransfer;
+}
+
 void DataProcess::setLastError(const std::string& errorMessage)
 {
     m_lastError = errorMessage;
@@ -194,7 +216,6 @@ CurveCollection DataProcess::readStepCurves(const std::string& stepFilePath, dou
     {
         // Create STEP reader
         STEPControl_Reader reader;
-        Message_ProgressRange emptyProgress;
         
         // Read STEP file
         IFSelect_ReturnStatus status = reader.ReadFile(stepFilePath.c_str());
@@ -204,16 +225,15 @@ CurveCollection DataProcess::readStepCurves(const std::string& stepFilePath, dou
             return result;
         }
         
-        // Transfer roots
-        int nbRoots = reader.TransferRoots(emptyProgress);
+        // Transfer roots and get the shape
+        int nbRoots = 0;
+        TopoDS_Shape shape = transferStepRoots(reader, m_parallelTransfer, nbRoots);
         if (nbRoots == 0)
         {
             setLastError("No shapes found in STEP file: " + stepFilePath);
             return result;
         }
         
-        // Get the shape
-        TopoDS_Shape shape = reader.OneShape();
         if (shape.IsNull())
         {
             setLastError("Failed to get shape from STEP file: " + stepFilePath);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <IFSelect_PrintCount.hxx>
+#include <STEPControl_Reader.hxx>
+#include <TopoDS_Shape.hxx>
+#include <XSControl_WorkSession.hxx>
+#include <vector>
+
+/**
+ * @class ParallelStepTransfer
+ * @brief Transfers the roots of an already-read STEP file on worker threads.
+ *
+ * STEPControl_Reader::TransferRoots() converts every root to B-rep on one thread.
+ * Here the roots of the parsed model are partitioned across workers; each worker
+ * owns a separate transfer context (work session, controller and read actor) that
+ * shares only the read-only model and its entity graph, and the resulting shapes
+ * are merged back in root order.
+ *
+ * Because the workers do not share a transfer map, entities referenced by several
+ * roots are transferred once per worker and do not share TShapes across roots.
+ * Older OCCT releases keep unit factors in process-global state during transfer,
+ * so below OCCT 7.8 Perform() always falls back to the sequential TransferRoots().
+ *
+ * @code
+ *   STEPControl_Reader reader;
+ *   reader.ReadFile(path);
+ *   ParallelStepTransfer transfer(reader);
+ *   transfer.Perform();
+ *   TopoDS_Shape shape = transfer.OneShape();
+ * @endcode
+ */
+class ParallelStepTransfer {
+public:
+    /**
+     * @brief Constructor
+     * @param reader Reader on which ReadFile() already succeeded
+     */
+    explicit ParallelStepTransfer(STEPControl_Reader& reader);
+
+    /// Set whether worker threads are used at all (false = plain TransferRoots())
+    void SetParallel(bool parallel) { m_parallel = parallel; }
+
+    /// Set the number of workers (0 = number of logical processors)
+    void SetThreadCount(int threadCount) { m_threadCount = threadCount; }
+
+    /// Set the minimum number of roots for which parallel transfer is used
+    void SetMinRootsForParallel(int minRoots) { m_minRootsForParallel = minRoots; }
+
+    /**
+     * @brief Transfers all roots
+     * @return Number of roots that produced a shape
+     */
+    int Perform();
+
+    /// Shapes of the transferred roots in root order (null entries for failed roots)
+    const std::vector<TopoDS_Shape>& GetShapes() const { return m_shapes; }
+
+    /// Returns the single transferred shape, or a compound of all of them
+    TopoDS_Shape OneShape() const;
+
+    /// Returns true if the last Perform() ran on worker threads
+    bool WasParallel() const { return m_wasParallel; }
+
+    /**
+     * @brief Prints the check messages of the last transfer, like STEPControl_Reader::PrintCheckTransfer()
+     *
+     * After a parallel transfer the messages are printed per worker, each for the roots
+     * that worker transferred; the reader's own transfer process holds none of them.
+     * @param failsOnly Print only failures, no warnings
+     * @param mode How the messages are grouped
+     */
+    void PrintCheckTransfer(bool failsOnly, IFSelect_PrintCount mode) const;
+
+    /// Returns true if this OCCT build supports parallel transfer
+    static bool IsSupported();
+
+private:
+    int PerformSequential();
+
+    STEPControl_Reader& m_reader;
+    std::vector<TopoDS_Shape> m_shapes;
+    std::vector<Handle(XSControl_WorkSession)> m_workerSessions;  // Transfer contexts of the last parallel run
+    int m_threadCount;
+    int m_minRootsForParallel;
+    bool m_parallel;
+    bool m_wasParallel;
+};
@@ -0,0 +1,166 @@
+#include "ParallelStepTransfer.h"
+
+#include <BRep_Builder.hxx>
+#include <Interface_CheckIterator.hxx>
+#include <Interface_HGraph.hxx>
+#include <Interface_InterfaceModel.hxx>
+#include <Message.hxx>
+#include <Message_Messenger.hxx>
+#include <OSD_Parallel.hxx>
+#include <Standard_ErrorHandler.hxx>
+#include <Standard_Failure.hxx>
+#include <Standard_Version.hxx>
+#include <STEPControl_Controller.hxx>
+#include <TopoDS_Compound.hxx>
+#include <Transfer_TransientProcess.hxx>
+#include <XSControl_TransferReader.hxx>
+
+#include <algorithm>
+
+ParallelStepTransfer::ParallelStepTransfer(STEPControl_Reader& reader)
+    : m_reader(reader)
+    , m_threadCount(0)
+    , m_minRootsForParallel(4)
+    , m_parallel(true)
+    , m_wasParallel(false)
+{
+}
+
+bool ParallelStepTransfer::IsSupported()
+{
+#if OCC_VERSION_HEX >= 0x070800
+    return true;
+#else
+    return false;
+#endif
+}
+
+int ParallelStepTransfer::Perform()
+{
+    m_shapes.clear();
+    m_workerSessions.clear();
+    m_wasParallel = false;
+
+    const int rootCount = m_reader.NbRootsForTransfer();
+    Handle(Interface_InterfaceModel) model = m_reader.Model();
+    if (!m_parallel || !IsSupported() || model.IsNull() || rootCount < std::max(2, m_minRootsForParallel)) {
+        return PerformSequential();
+    }
+
+    int workerCount = m_threadCount > 0 ? m_threadCount : OSD_Parallel::NbLogicalProcessors();
+    workerCount = std::max(1, std::min(workerCount, rootCount));
+
+    std::vector<Handle(Standard_Transient)> roots(rootCount);
+    for (int i = 1; i <= rootCount; i++) {
+        roots[i - 1] = m_reader.RootForTransfer(i);
+    }
+
+    // Transfer contexts are set up here, on the calling thread: the controller
+    // registry, static parameters and the entity graph computation are not
+    // thread-safe. Each context gets its own controller so that the read actors,
+    // which carry per-transfer state, are not shared either. The entity graph of the
+    // model is computed once, by the reader's session; transfer only reads it, so all
+    // workers share it instead of building one graph of the whole model each.
+    Handle(Interface_HGraph) graph = m_reader.WS()->HGraph();
+    std::vector<Handle(XSControl_TransferReader)> workers(workerCount);
+    for (int w = 0; w < workerCount; w++) {
+        Handle(STEPControl_Controller) controller = new STEPControl_Controller;
+        Handle(XSControl_WorkSession) session = new XSControl_WorkSession;
+        session->SetController(controller);
+        session->SetModel(model, Standard_False);
+
+        Handle(XSControl_TransferReader) transferReader = session->TransferReader();
+        transferReader->SetController(controller);
+        transferReader->SetModel(model);
+        transferReader->SetGraph(graph);
+        transferReader->SetActor(controller->ActorRead(model));
+        workers[w] = transferReader;
+        m_workerSessions.push_back(session);
+    }
+
+    // Roots are dealt round-robin so large neighbouring products spread over workers
+    m_shapes.resize(rootCount);
+    OSD_Parallel::For(0, workerCount, [&](int w) {
+        const Handle(XSControl_TransferReader)& worker = workers[w];
+        for (int i = w; i < rootCount; i += workerCount) {
+            try {
+                OCC_CATCH_SIGNALS
+                if (worker->TransferOne(roots[i]) > 0) {
+                    m_shapes[i] = worker->ShapeResult(roots[i]);
+                }
+            }
+            catch (const Standard_Failure&) {
+                // Leave the root's entry null, like a failed sequential transfer
+            }
+        }
+    });
+
+    m_wasParallel = true;
+    return static_cast<int>(std::count_if(m_shapes.begin(), m_shapes.end(),
+        [](const TopoDS_Shape& shape) { return !shape.IsNull(); }));
+}
+
+int ParallelStepTransfer::PerformSequential()
+{
+    m_reader.TransferRoots();
+
+    int transferred = 0;
+    for (int i = 1; i <= m_reader.NbShapes(); i++) {
+        TopoDS_Shape shape = m_reader.Shape(i);
+        if (!shape.IsNull()) {
+            transferred++;
+        }
+        m_shapes.push_back(shape);
+    }
+    return transferred;
+}
+
+void ParallelStepTransfer::PrintCheckTransfer(bool failsOnly, IFSelect_PrintCount mode) const
+{
+    if (!m_wasParallel) {
+        m_reader.PrintCheckTransfer(failsOnly, mode);
+        return;
+    }
+
+    // Every worker's transfer process holds the checks of the roots it transferred
+    for (size_t w = 0; w < m_workerSessions.size(); w++) {
+        const Handle(XSControl_WorkSession)& session = m_workerSessions[w];
+        Handle(Transfer_TransientProcess) process = session->TransferReader()->TransientProcess();
+        if (process.IsNull()) {
+            continue;
+        }
+
+        Interface_CheckIterator checks = process->CheckList(Standard_False);
+        if (checks.IsEmpty(failsOnly)) {
+            continue;
+        }
+        Message::SendInfo() << "Transfer worker " << static_cast<int>(w + 1) << " of "
+                            << static_cast<int>(m_workerSessions.size()) << ":";
+        session->PrintCheckList(Message::SendInfo(), checks, failsOnly, mode);
+    }
+}
+
+TopoDS_Shape ParallelStepTransfer::OneShape() const
+{
+    std::vector<TopoDS_Shape> shapes;
+    for (const TopoDS_Shape& shape : m_shapes) {
+        if (!shape.IsNull()) {
+            shapes.push_back(shape);
+        }
+    }
+
+    if (shapes.empty()) {
+        return TopoDS_Shape();
+    }
+    if (shapes.size() == 1) {
+        return shapes.front();
+    }
+
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    for (const TopoDS_Shape& shape : shapes) {
+        builder.Add(compound, shape);
+    }
+    return compound;
+}
@@ -0,0 +1,400 @@
+// Headless parameter-sweep benchmark for the meshability analyzers.
+//
+// Runs MeshabilitySeparator, STLExportFilter, STLExportDiagnoser,
+// STLMultiLevelExporter and MeshRemover over a procedurally generated corpus
+// (primitives, fillets and boolean operations - no external data) across a grid
+// of deflection/angle values and prints one CSV row per run:
+//
+//   analyzer,shape,faces,deflection,angle,wall_ms,mesh_attempts,triangles,meshable,non_meshable,rss_growth_mib
+//
+// Usage:
+//   MeshabilityBenchmark [--deflections 0.1,0.01] [--angles 0.5,0.2]
+//                        [--analyzer NAME] [--shape NAME] [--output file.csv]
+//
+// triangles are those the analyzer generated on the shapes it meshed itself (e.g. the
+// ShapeFix copies of MeshabilitySeparator). rss_growth_mib is the working set after the
+// run minus the one before it; memory freed by earlier runs may be reused without growth,
+// so use --analyzer/--shape to measure one configuration per process where that matters.
+
+#include "MeshabilitySeparator.h"
+#include "STLExportFilter.h"
+#include "STLExportDiagnoser.h"
+#include "STLMultiLevelExporter.h"
+#include "MeshRemover.h"
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <BRepPrimAPI_MakeTorus.hxx>
+#include <BRepPrimAPI_MakeCone.hxx>
+#include <BRepFilletAPI_MakeFillet.hxx>
+#include <BRepAlgoAPI_Cut.hxx>
+#include <BRepAlgoAPI_Fuse.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Iterator.hxx>
+#include <OSD_MemInfo.hxx>
+#include <gp.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Trsf.hxx>
+#include <Standard_Failure.hxx>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CorpusShape {
+    std::string name;
+    TopoDS_Shape shape;
+};
+
+struct RunMetrics {
+    int meshAttempts = 0;
+    int triangles = 0;
+    int meshable = 0;
+    int nonMeshable = 0;
+};
+
+// Analyzer entry: runs one analysis of a shape at (deflection, angle)
+struct Analyzer {
+    std::string name;
+    bool supportsAngle;
+    std::function<RunMetrics(const TopoDS_Shape&, double, double)> run;
+};
+
+// ========== Corpus ==========
+
+TopoDS_Shape filletAllEdges(const TopoDS_Shape& shape, double radius)
+{
+    BRepFilletAPI_MakeFillet fillet(shape);
+    for (TopExp_Explorer exp(shape, TopAbs_EDGE); exp.More(); exp.Next()) {
+        fillet.Add(radius, TopoDS::Edge(exp.Current()));
+    }
+    fillet.Build();
+    return fillet.IsDone() ? fillet.Shape() : shape;
+}
+
+TopoDS_Shape makeFilletedBox()
+{
+    return filletAllEdges(BRepPrimAPI_MakeBox(40.0, 30.0, 20.0).Shape(), 3.0);
+}
+
+TopoDS_Shape makeDrilledBlock()
+{
+    TopoDS_Shape block = BRepPrimAPI_MakeBox(100.0, 60.0, 20.0).Shape();
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 3; j++) {
+            gp_Ax2 axis(gp_Pnt(12.0 + i * 19.0, 12.0 + j * 18.0, -1.0), gp::DZ());
+            TopoDS_Shape hole = BRepPrimAPI_MakeCylinder(axis, 4.0, 22.0).Shape();
+            block = BRepAlgoAPI_Cut(block, hole).Shape();
+        }
+    }
+    return block;
+}
+
+TopoDS_Shape makeTorusCone()
+{
+    TopoDS_Shape torus = BRepPrimAPI_MakeTorus(30.0, 8.0).Shape();
+    TopoDS_Shape cone = BRepPrimAPI_MakeCone(gp_Ax2(gp_Pnt(0.0, 0.0, -40.0), gp::DZ()), 20.0, 2.0, 80.0).Shape();
+    return BRepAlgoAPI_Fuse(torus, cone).Shape();
+}
+
+TopoDS_Shape makeSphereCross()
+{
+    TopoDS_Shape sphere = BRepPrimAPI_MakeSphere(25.0).Shape();
+    const gp_Dir axes[3] = { gp::DX(), gp::DY(), gp::DZ() };
+    for (const gp_Dir& dir : axes) {
+        gp_Pnt origin(-30.0 * dir.X(), -30.0 * dir.Y(), -30.0 * dir.Z());
+        TopoDS_Shape bar = BRepPrimAPI_MakeCylinder(gp_Ax2(origin, dir), 8.0, 60.0).Shape();
+        sphere = BRepAlgoAPI_Cut(sphere, bar).Shape();
+    }
+    return sphere;
+}
+
+TopoDS_Shape makeAssembly(int countX, int countY)
+{
+    // Compound of independent filleted parts, similar to a flattened assembly
+    TopoDS_Shape part = filletAllEdges(BRepPrimAPI_MakeCylinder(6.0, 15.0).Shape(), 1.0);
+
+    BRep_Builder builder;
+    TopoDS_Compound assembly;
+    builder.MakeCompound(assembly);
+    for (int i = 0; i < countX; i++) {
+        for (int j = 0; j < countY; j++) {
+            gp_Trsf trsf;
+            trsf.SetTranslation(gp_Vec(i * 15.0, j * 15.0, 0.0));
+            builder.Add(assembly, BRepBuilderAPI_Transform(part, trsf, Standard_True).Shape());
+        }
+    }
+    return assembly;
+}
+
+std::vector<CorpusShape> buildCorpus()
+{
+    std::vector<CorpusShape> corpus;
+    corpus.push_back({ "box", BRepPrimAPI_MakeBox(40.0, 30.0, 20.0).Shape() });
+    corpus.push_back({ "filleted_box", makeFilletedBox() });
+    corpus.push_back({ "drilled_block", makeDrilledBlock() });
+    corpus.push_back({ "torus_cone", makeTorusCone() });
+    corpus.push_back({ "sphere_cross", makeSphereCross() });
+    corpus.push_back({ "assembly_8x8", makeAssembly(8, 8) });
+    return corpus;
+}
+
+// ========== Analyzers ==========
+
+int countTriangles(const TopoDS_Shape& shape)
+{
+    int triangles = 0;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), loc);
+        if (!triangulation.IsNull()) {
+            triangles += triangulation->NbTriangles();
+        }
+    }
+    return triangles;
+}
+
+int countChildren(const TopoDS_Shape& compound)
+{
+    int count = 0;
+    for (TopoDS_Iterator it(compound); it.More(); it.Next()) {
+        count++;
+    }
+    return count;
+}
+
+std::vector<Analyzer> buildAnalyzers()
+{
+    std::vector<Analyzer> analyzers;
+
+    analyzers.push_back({ "MeshabilitySeparator", true,
+        [](const TopoDS_Shape& shape, double deflection, double angle) {
+            MeshabilitySeparator separator(deflection, angle);
+            separator.SetVerbose(false);
+            separator.SetKeepShapeInfo(false);
+
+            TopoDS_Compound meshableParts, nonMeshableParts;
+            separator.Separate(shape, meshableParts, nonMeshableParts);
+
+            RunMetrics metrics;
+            metrics.meshAttempts = separator.GetStatistics().meshAttempts;
+            // The input's faces stay untouched when a ShapeFix copy is meshed
+            metrics.triangles = separator.GetStatistics().meshedTriangles;
+            metrics.meshable = countChildren(meshableParts);
+            metrics.nonMeshable = countChildren(nonMeshableParts);
+            return metrics;
+        } });
+
+    analyzers.push_back({ "STLExportFilter", false,
+        [](const TopoDS_Shape& shape, double deflection, double) {
+            STLExportFilter filter(deflection);
+
+            TopoDS_Compound exportableParts, nonExportableParts;
+            filter.separate(shape, exportableParts, nonExportableParts);
+
+            RunMetrics metrics;
+            metrics.meshAttempts = filter.getMeshAttemptCount();
+            metrics.triangles = countTriangles(shape);
+            metrics.meshable = countChildren(exportableParts);
+            metrics.nonMeshable = countChildren(nonExportableParts);
+            return metrics;
+        } });
+
+    analyzers.push_back({ "STLExportDiagnoser", false,
+        [](const TopoDS_Shape& shape, double deflection, double) {
+            STLExportDiagnoser diagnoser(deflection);
+            std::vector<MeshDiagnosis> diagnoses = diagnoser.diagnoseShape(shape);
+
+            RunMetrics metrics;
+            metrics.meshAttempts = diagnoser.getMeshAttemptCount();
+            metrics.triangles = countTriangles(shape);
+            for (const auto& diag : diagnoses) {
+                if (diag.isMeshable) {
+                    metrics.meshable++;
+                } else {
+                    metrics.nonMeshable++;
+                }
+            }
+            return metrics;
+        } });
+
+    analyzers.push_back({ "STLMultiLevelExporter", false,
+        [](const TopoDS_Shape& shape, double deflection, double) {
+            STLMultiLevelExporter exporter(deflection);
+            exporter.setKeepResults(false);
+            exporter.decomposeAndAnalyze(shape);
+
+            RunMetrics metrics;
+            metrics.meshAttempts = exporter.getMeshAttemptCount();
+            metrics.triangles = countTriangles(shape);
+            metrics.meshable = exporter.getSuccessCount();
+            metrics.nonMeshable = exporter.getFailureCount();
+            return metrics;
+        } });
+
+    analyzers.push_back({ "MeshRemover", true,
+        [](const TopoDS_Shape& shape, double deflection, double angle) {
+            MeshRemover remover(deflection, angle);
+
+            TopoDS_Shape remaining;
+            remover.removeMeshableParts(shape, remaining);
+
+            RunMetrics metrics;
+            metrics.meshAttempts = remover.getMeshAttemptCount();
+            metrics.triangles = countTriangles(shape);
+            metrics.meshable = remover.getMeshablePartCount();
+            metrics.nonMeshable = remover.getNonMeshablePartCount();
+            return metrics;
+        } });
+
+    return analyzers;
+}
+
+// ========== Measurement helpers ==========
+
+double workingSetMiB()
+{
+    OSD_MemInfo memInfo(Standard_False);
+    memInfo.Update();
+    return memInfo.ValuePreciseMiB(OSD_MemInfo::MemWorkingSet);
+}
+
+std::vector<double> parseList(const char* text)
+{
+    std::vector<double> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(std::atof(item.c_str()));
+        }
+    }
+    return values;
+}
+
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program
+              << " [--deflections d1,d2,...] [--angles a1,a2,...]"
+              << " [--analyzer NAME] [--shape NAME] [--output file.csv]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<double> deflections = { 0.1, 0.01, 0.001 };
+    std::vector<double> angles = { 0.5, 0.2 };
+    std::string analyzerFilter;
+    std::string shapeFilter;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--deflections") == 0 && hasValue) {
+            deflections = parseList(argv[++i]);
+        } else if (std::strcmp(argv[i], "--angles") == 0 && hasValue) {
+            angles = parseList(argv[++i]);
+        } else if (std::strcmp(argv[i], "--analyzer") == 0 && hasValue) {
+            analyzerFilter = argv[++i];
+        } else if (std::strcmp(argv[i], "--shape") == 0 && hasValue) {
+            shapeFilter = argv[++i];
+        } else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (deflections.empty() || angles.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath);
+        if (!outputFile.is_open()) {
+            std::cerr << "Error: cannot open " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& csv = outputPath.empty() ? std::cout : outputFile;
+
+    std::vector<CorpusShape> corpus = buildCorpus();
+    std::vector<Analyzer> analyzers = buildAnalyzers();
+
+    csv << "analyzer,shape,faces,deflection,angle,wall_ms,mesh_attempts,triangles,meshable,non_meshable,rss_growth_mib\n";
+
+    for (const auto& analyzer : analyzers) {
+        if (!analyzerFilter.empty() && analyzer.name != analyzerFilter) {
+            continue;
+        }
+
+        // Analyzers without an angle parameter use BRepMesh's default of 0.5
+        const std::vector<double> analyzerAngles = analyzer.supportsAngle ? angles : std::vector<double>{ 0.5 };
+
+        for (const auto& item : corpus) {
+            if (!shapeFilter.empty() && item.name != shapeFilter) {
+                continue;
+            }
+
+            TopTools_IndexedMapOfShape faces;
+            TopExp::MapShapes(item.shape, TopAbs_FACE, faces);
+
+            for (double deflection : deflections) {
+                for (double angle : analyzerAngles) {
+                    // Start every run cold: triangulations from the previous run would be reused
+                    BRepTools::Clean(item.shape);
+
+                    RunMetrics metrics;
+                    const double memoryBefore = workingSetMiB();
+                    auto start = std::chrono::steady_clock::now();
+                    try {
+                        metrics = analyzer.run(item.shape, deflection, angle);
+                    } catch (Standard_Failure const& failure) {
+                        std::cerr << analyzer.name << "/" << item.name << ": " << failure.GetMessageString() << std::endl;
+                        continue;
+                    }
+                    auto end = std::chrono::steady_clock::now();
+                    std::chrono::duration<double, std::milli> elapsed = end - start;
+                    const double memoryGrowth = workingSetMiB() - memoryBefore;
+
+                    csv << analyzer.name << ','
+                        << item.name << ','
+                        << faces.Extent() << ','
+                        << deflection << ','
+                        << angle << ','
+                        << elapsed.count() << ','
+                        << metrics.meshAttempts << ','
+                        << metrics.triangles << ','
+                        << metrics.meshable << ','
+                        << metrics.nonMeshable << ','
+                        << memoryGrowth << '\n';
+                    csv.flush();
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,386 @@
+// Offscreen rendering benchmark for the geometry formats of ShapeUtil.
+//
+// Converts a procedurally generated corpus (no external data) with indexed face
+// sets and with interleaved triangle buffers, renders every scene with
+// SoOffscreenRenderer while the model spins, and prints one CSV row per run:
+//
+//   format,shape,triangles,build_ms,scene_kib,first_frame_ms,mean_frame_ms,min_frame_ms,drawn_triangles,culled_triangles,rss_mib
+//
+// Usage:
+//   RenderBenchmark [--format ifs|buffer] [--shape NAME] [--frames N]
+//                   [--size WxH] [--zoom Z] [--deviation D] [--output file.csv]
+//
+// Without a display, run it on a software GL, e.g.
+//   LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe xvfb-run ./RenderBenchmark
+//
+// build_ms covers the conversion of an already meshed shape. Frame times include
+// the pixel readback of SoOffscreenRenderer, which is the same for both formats;
+// first_frame_ms also covers the buffer uploads. scene_kib counts the vertex and
+// index arrays of the scene graph; GL driver copies only show up in rss_mib, the
+// working set after rendering, so use --format to measure one format per process.
+
+#include "ShapeUtil.h"
+#include "SoInterleavedTriangleSet.h"
+#include "ViewTool.h"
+
+#include <Inventor/SoDB.h>
+#include <Inventor/SoOffscreenRenderer.h>
+#include <Inventor/SbViewportRegion.h>
+#include <Inventor/nodes/SoSeparator.h>
+#include <Inventor/nodes/SoPerspectiveCamera.h>
+#include <Inventor/nodes/SoDirectionalLight.h>
+#include <Inventor/nodes/SoRotation.h>
+#include <Inventor/nodes/SoCoordinate3.h>
+#include <Inventor/nodes/SoNormal.h>
+#include <Inventor/nodes/SoIndexedShape.h>
+#include <Inventor/nodes/SoLineSet.h>
+#include <Inventor/nodes/SoVertexProperty.h>
+
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <BRepPrimAPI_MakeTorus.hxx>
+#include <BRepFilletAPI_MakeFillet.hxx>
+#include <BRepAlgoAPI_Cut.hxx>
+#include <BRepBuilderAPI_Transform.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <OSD_MemInfo.hxx>
+#include <gp.hxx>
+#include <gp_Ax2.hxx>
+#include <gp_Trsf.hxx>
+#include <Standard_Failure.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CorpusShape {
+    std::string name;
+    TopoDS_Shape shape;
+};
+
+struct Format {
+    std::string name;
+    ShapeUtil::GeometryFormat format;
+};
+
+// ========== Corpus ==========
+
+TopoDS_Shape filletAllEdges(const TopoDS_Shape& shape, double radius)
+{
+    BRepFilletAPI_MakeFillet fillet(shape);
+    for (TopExp_Explorer exp(shape, TopAbs_EDGE); exp.More(); exp.Next()) {
+        fillet.Add(radius, TopoDS::Edge(exp.Current()));
+    }
+    fillet.Build();
+    return fillet.IsDone() ? fillet.Shape() : shape;
+}
+
+TopoDS_Shape makeDrilledBlock()
+{
+    TopoDS_Shape block = BRepPrimAPI_MakeBox(100.0, 60.0, 20.0).Shape();
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 3; j++) {
+            gp_Ax2 axis(gp_Pnt(12.0 + i * 19.0, 12.0 + j * 18.0, -1.0), gp::DZ());
+            TopoDS_Shape hole = BRepPrimAPI_MakeCylinder(axis, 4.0, 22.0).Shape();
+            block = BRepAlgoAPI_Cut(block, hole).Shape();
+        }
+    }
+    return block;
+}
+
+TopoDS_Shape makeSphereCross()
+{
+    TopoDS_Shape sphere = BRepPrimAPI_MakeSphere(25.0).Shape();
+    const gp_Dir axes[3] = { gp::DX(), gp::DY(), gp::DZ() };
+    for (const gp_Dir& dir : axes) {
+        gp_Pnt origin(-30.0 * dir.X(), -30.0 * dir.Y(), -30.0 * dir.Z());
+        TopoDS_Shape bar = BRepPrimAPI_MakeCylinder(gp_Ax2(origin, dir), 8.0, 60.0).Shape();
+        sphere = BRepAlgoAPI_Cut(sphere, bar).Shape();
+    }
+    return sphere;
+}
+
+TopoDS_Shape makeAssembly(int countX, int countY)
+{
+    // Compound of independent filleted parts, similar to a flattened assembly
+    TopoDS_Shape part = filletAllEdges(BRepPrimAPI_MakeCylinder(6.0, 15.0).Shape(), 1.0);
+
+    BRep_Builder builder;
+    TopoDS_Compound assembly;
+    builder.MakeCompound(assembly);
+    for (int i = 0; i < countX; i++) {
+        for (int j = 0; j < countY; j++) {
+            gp_Trsf trsf;
+            trsf.SetTranslation(gp_Vec(i * 15.0, j * 15.0, 0.0));
+            builder.Add(assembly, BRepBuilderAPI_Transform(part, trsf, Standard_True).Shape());
+        }
+    }
+    return assembly;
+}
+
+std::vector<CorpusShape> buildCorpus()
+{
+    std::vector<CorpusShape> corpus;
+    corpus.push_back({ "torus", BRepPrimAPI_MakeTorus(30.0, 8.0).Shape() });
+    corpus.push_back({ "drilled_block", makeDrilledBlock() });
+    corpus.push_back({ "sphere_cross", makeSphereCross() });
+    corpus.push_back({ "assembly_16x16", makeAssembly(16, 16) });
+    return corpus;
+}
+
+// ========== Measurement helpers ==========
+
+int countTriangles(const TopoDS_Shape& shape)
+{
+    int triangles = 0;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        TopLoc_Location loc;
+        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), loc);
+        if (!triangulation.IsNull()) {
+            triangles += triangulation->NbTriangles();
+        }
+    }
+    return triangles;
+}
+
+// Bytes of the vertex and index arrays below the node; shared nodes are counted once
+size_t sceneBytes(SoNode* node, std::set<SoNode*>& visited)
+{
+    if (!node || !visited.insert(node).second) {
+        return 0;
+    }
+
+    size_t bytes = 0;
+    if (node->isOfType(SoCoordinate3::getClassTypeId())) {
+        bytes += static_cast<SoCoordinate3*>(node)->point.getNum() * sizeof(SbVec3f);
+    }
+    else if (node->isOfType(SoNormal::getClassTypeId())) {
+        bytes += static_cast<SoNormal*>(node)->vector.getNum() * sizeof(SbVec3f);
+    }
+    else if (node->isOfType(SoIndexedShape::getClassTypeId())) {
+        bytes += static_cast<SoIndexedShape*>(node)->coordIndex.getNum() * sizeof(int32_t);
+    }
+    else if (node->isOfType(SoLineSet::getClassTypeId())) {
+        SoLineSet* lineSet = static_cast<SoLineSet*>(node);
+        bytes += lineSet->numVertices.getNum() * sizeof(int32_t);
+        bytes += sceneBytes(lineSet->vertexProperty.getValue(), visited);
+    }
+    else if (node->isOfType(SoVertexProperty::getClassTypeId())) {
+        SoVertexProperty* property = static_cast<SoVertexProperty*>(node);
+        bytes += (property->vertex.getNum() + property->normal.getNum()) * sizeof(SbVec3f);
+    }
+    else if (node->isOfType(SoInterleavedTriangleSet::getClassTypeId())) {
+        bytes += static_cast<SoInterleavedTriangleSet*>(node)->getMemoryUsage();
+    }
+
+    SoChildList* children = node->getChildren();
+    if (children) {
+        for (int i = 0; i < children->getLength(); i++) {
+            bytes += sceneBytes((*children)[i], visited);
+        }
+    }
+    return bytes;
+}
+
+double workingSetMiB()
+{
+    OSD_MemInfo memInfo(Standard_False);
+    memInfo.Update();
+    return memInfo.ValuePreciseMiB(OSD_MemInfo::MemWorkingSet);
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void printUsage(const char* program)
+{
+    std::cerr << "Usage: " << program
+              << " [--format ifs|buffer] [--shape NAME] [--frames N] [--size WxH]"
+              << " [--zoom Z] [--deviation D] [--output file.csv]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string formatFilter;
+    std::string shapeFilter;
+    std::string outputPath;
+    int frames = 100;
+    int width = 1024;
+    int height = 768;
+    double zoom = 1.0;
+    double deviation = 0.001;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--format") == 0 && hasValue) {
+            formatFilter = argv[++i];
+        } else if (std::strcmp(argv[i], "--shape") == 0 && hasValue) {
+            shapeFilter = argv[++i];
+        } else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+            frames = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--zoom") == 0 && hasValue) {
+            zoom = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--deviation") == 0 && hasValue) {
+            deviation = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (frames < 1 || width < 1 || height < 1 || zoom <= 0.0 || deviation <= 0.0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream outputFile;
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath);
+        if (!outputFile.is_open()) {
+            std::cerr << "Error: cannot open " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& csv = outputPath.empty() ? std::cout : outputFile;
+
+    SoDB::init();
+    SoInterleavedTriangleSet::initClass();
+    // The drawn and culled counts of the report come from the chunk callbacks
+    ShapeUtil::setRenderStatistics(true);
+
+    const std::vector<Format> formats = {
+        { "ifs", ShapeUtil::GeometryFormat::IndexedFaceSet },
+        { "buffer", ShapeUtil::GeometryFormat::TriangleBuffer },
+    };
+    std::vector<CorpusShape> corpus = buildCorpus();
+
+    const SbViewportRegion viewport(static_cast<short>(width), static_cast<short>(height));
+    SoOffscreenRenderer renderer(viewport);
+
+    csv << "format,shape,triangles,build_ms,scene_kib,first_frame_ms,mean_frame_ms,min_frame_ms,drawn_triangles,culled_triangles,rss_mib\n";
+
+    for (const auto& item : corpus) {
+        if (!shapeFilter.empty() && item.name != shapeFilter) {
+            continue;
+        }
+
+        // Both formats convert the same triangulation
+        BRepTools::Clean(item.shape);
+        try {
+            ShapeUtil::meshShape(item.shape, ViewTool::getDeflection(item.shape, deviation), 0.1);
+        } catch (Standard_Failure const& failure) {
+            std::cerr << item.name << ": " << failure.GetMessageString() << std::endl;
+            continue;
+        }
+        const int triangles = countTriangles(item.shape);
+
+        for (const auto& format : formats) {
+            if (!formatFilter.empty() && format.name != formatFilter) {
+                continue;
+            }
+
+            ShapeUtil::setGeometryFormat(format.format);
+
+            auto start = std::chrono::steady_clock::now();
+            SoSeparator* model = ShapeUtil::convertMeshedShape(item.shape);
+            const double buildMs = elapsedMs(start);
+            if (!model) {
+                std::cerr << format.name << "/" << item.name << ": conversion failed" << std::endl;
+                continue;
+            }
+
+            SoSeparator* root = new SoSeparator;
+            root->ref();
+            SoPerspectiveCamera* camera = new SoPerspectiveCamera;
+            root->addChild(camera);
+            root->addChild(new SoDirectionalLight);
+            SoRotation* spin = new SoRotation;
+            root->addChild(spin);
+            root->addChild(model);
+
+            camera->viewAll(root, viewport);
+            if (zoom != 1.0) {
+                // Move towards the focal point; parts of the model leave the view and get culled
+                SbVec3f direction;
+                camera->orientation.getValue().multVec(SbVec3f(0.0f, 0.0f, -1.0f), direction);
+                const float distance = camera->focalDistance.getValue();
+                const SbVec3f focal = camera->position.getValue() + direction * distance;
+                camera->position.setValue(focal - direction * static_cast<float>(distance / zoom));
+                camera->focalDistance.setValue(static_cast<float>(distance / zoom));
+                camera->nearDistance.setValue(camera->nearDistance.getValue() / static_cast<float>(zoom));
+            }
+
+            std::set<SoNode*> visited;
+            const size_t bytes = sceneBytes(root, visited);
+
+            start = std::chrono::steady_clock::now();
+            const bool rendered = renderer.render(root);
+            const double firstFrameMs = elapsedMs(start);
+            if (!rendered) {
+                std::cerr << format.name << "/" << item.name << ": offscreen rendering failed" << std::endl;
+                root->unref();
+                continue;
+            }
+
+            double totalMs = 0.0;
+            double minMs = 0.0;
+            for (int frame = 0; frame < frames; frame++) {
+                spin->rotation.setValue(SbVec3f(0.0f, 1.0f, 0.0f), static_cast<float>(2.0 * M_PI * frame / frames));
+                ShapeUtil::resetRenderStatistics();
+
+                start = std::chrono::steady_clock::now();
+                renderer.render(root);
+                const double frameMs = elapsedMs(start);
+                totalMs += frameMs;
+                minMs = frame == 0 ? frameMs : std::min(minMs, frameMs);
+            }
+            const ShapeUtil::RenderStatistics stats = ShapeUtil::renderStatistics();
+
+            csv << format.name << ','
+                << item.name << ','
+                << triangles << ','
+                << buildMs << ','
+                << bytes / 1024.0 << ','
+                << firstFrameMs << ','
+                << totalMs / frames << ','
+                << minMs << ','
+                << stats.triangles - stats.culledTriangles << ','
+                << stats.culledTriangles << ','
+                << workingSetMiB() << '\n';
+            csv.flush();
+
+            root->unref();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <cstddef>
+
+/**
+ * @class AnalysisRecordWriter
+ * @brief Streams analysis results as JSON lines (one flat JSON object per line).
+ *
+ * Analyzers write a record as soon as a shape is classified, so batch audits can
+ * run in bounded memory instead of accumulating per-shape result objects.
+ *
+ * Usage:
+ * @code
+ *   AnalysisRecordWriter writer(file);
+ *   writer.beginRecord("shape");
+ *   writer.field("meshable", true);
+ *   writer.field("faces", 12);
+ *   writer.endRecord();
+ * @endcode
+ */
+class AnalysisRecordWriter {
+public:
+    /**
+     * @brief Constructor
+     * @param out Output stream receiving the records (must outlive the writer)
+     */
+    explicit AnalysisRecordWriter(std::ostream& out);
+
+    /**
+     * @brief Starts a new record
+     * @param recordType Value of the "record" key identifying the record kind
+     */
+    void beginRecord(const char* recordType);
+
+    /// Adds a key/value pair to the current record
+    void field(const char* key, const std::string& value);
+    void field(const char* key, const char* value);
+    void field(const char* key, int value);
+    void field(const char* key, long long value);
+    void field(const char* key, double value);
+    void field(const char* key, bool value);
+
+    /// Terminates the current record with a newline
+    void endRecord();
+
+    /// Flushes the underlying stream
+    void flush();
+
+    /// Returns the number of completed records
+    std::size_t getRecordCount() const { return recordCount_; }
+
+private:
+    void writeKey(const char* key);
+    void writeString(const char* value, std::size_t length);
+
+    std::ostream& out_;
+    bool inRecord_;
+    std::size_t recordCount_;
+};
@@ -16,6 +16,8 @@
 class OccWidget;
 class STEPLoader;
 class IGESLoader;
+class Bnd_Box;
+class TopoDS_Shape;
 
 class AnotherMainWindow : public QMainWindow{
     Q_OBJECT
@@ -57,6 +59,8 @@ private slots:
 private:
     void setupUI();
     void setupConnections();
+    void onRootTransferred(int rootIndex, int rootCount, const Bnd_Box& box);
+    void onRootLoaded(int rootIndex, int rootCount, const TopoDS_Shape& shape);
 
 private:
     OccWidget* m_occWidget;
@@ -68,6 +72,7 @@ private:
     QHBoxLayout* m_controlLayout;
     QLabel* m_infoLabel;
     QProgressBar* m_progressBar;
+    int m_loadedRootCount;
     
     // Menu related members
     QMenuBar* m_menuBar;
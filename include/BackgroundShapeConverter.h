@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QThreadPool>
+#include <TopoDS_Shape.hxx>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class QObject;
+class SoNode;
+
+/**
+ * @class BackgroundShapeConverter
+ * @brief Converts the parts of a shape to Coin3D nodes on a worker thread and hands every
+ *        finished part to the GUI thread, so a viewer stays responsive while it fills up.
+ *
+ * Conversions run one after another on a private single-thread pool: parts of one viewer
+ * may share TShapes, and meshing the same faces from two threads at once is not safe.
+ * Meshing and the face fill inside a conversion are still parallel.
+ *
+ * cancel() drops everything that was started before it. Parts that are already queued for
+ * the GUI thread are discarded there, and the worker stops before its next part.
+ *
+ * @code
+ *   BackgroundShapeConverter::Callbacks callbacks;
+ *   callbacks.partReady = [this](SoNode* node, int, int) { m_modelRoot->addChild(node); };
+ *   m_converter->start(parts, [](const TopoDS_Shape& part) { return ShapeUtil::convertSingleShape(part); }, callbacks);
+ * @endcode
+ */
+class BackgroundShapeConverter {
+public:
+    /// Converts one part on the worker thread; returns nullptr on failure
+    using PartConverter = std::function<SoNode*(const TopoDS_Shape& part)>;
+
+    /// Callbacks invoked on the thread of the receiver
+    struct Callbacks {
+        std::function<void(SoNode* node, int index, int count)> partReady;  ///< A part is converted
+        std::function<void(int converted, int count)> finished;             ///< All parts are processed
+    };
+
+    /**
+     * @brief Constructor
+     * @param receiver Object whose thread runs the callbacks; must outlive this converter
+     */
+    explicit BackgroundShapeConverter(QObject* receiver);
+
+    /// Cancels and waits for the running conversion
+    ~BackgroundShapeConverter();
+
+    /**
+     * @brief Queues the conversion of the parts
+     * @param parts Shapes converted in order
+     * @param converter Conversion of one part, run on the worker thread
+     * @param callbacks Notifications on the receiver's thread
+     */
+    void start(const std::vector<TopoDS_Shape>& parts, PartConverter converter, Callbacks callbacks);
+
+    /**
+     * @brief Queues a task on the worker thread behind the conversions started so far
+     *
+     * The task sees the triangulation the conversions left on the shapes, with no meshing
+     * running at the same time. It is skipped if cancel() is called before it runs.
+     * @param task Work run on the worker thread; it reports back to the receiver itself
+     */
+    void queue(std::function<void()> task);
+
+    /// Cancels all conversions started so far
+    void cancel();
+
+    /// Blocks until the worker is idle
+    void waitForDone();
+
+private:
+    QObject* m_receiver;
+    QThreadPool m_pool;
+    std::shared_ptr<std::atomic_bool> m_canceled;
+};
@@ -4,8 +4,10 @@
 #include <TopoDS.hxx>
 #include <TopoDS_Shape.hxx>
 #include <TopoDS_Compound.hxx>
+#include <vector>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <BRep_Builder.hxx>
+#include "MeshingWatchdog.h"
 
 class MeshRemover {
 public:
@@ -23,10 +25,31 @@ public:
     double getDeflection() const;
     double getAngle() const;
     
+    // 设置单个形状三角剖分的时间预算（秒）与内存增长预算（MiB），<=0表示不限制
+    void setTimeLimit(double seconds);
+    void setMemoryLimit(double megabytes);
+    
+    // 有限内存模式：形状分类后立即用BRepTools::Clean释放探测时生成的三角剖分
+    // 注意：三角剖分附着在输入形状的面上，释放后导出STL前需要重新三角剖分
+    void setReleaseTriangulation(bool release);
+    
+    // 设置进程内存上限（MiB，<=0表示不限制），超过后强制释放上次释放以来新分类形状的三角剖分
+    // 内存在分类第一个形状时采样，之后每若干个形状或每隔一小段时间采样（见MemoryCeiling）
+    void setMemoryCeiling(double megabytes);
+    
+    // 获取因超过内存上限而强制释放的次数
+    int getForcedReleaseCount() const;
+    
     // 获取统计信息
     int getMeshablePartCount() const;
     int getNonMeshablePartCount() const;
     
+    // 获取因超出预算而中断三角剖分的形状数量
+    int getTimedOutPartCount() const;
+    
+    // 获取三角剖分尝试的次数
+    int getMeshAttemptCount() const;
+    
     // 获取可三角剖分的部分
     const TopoDS_Compound& getMeshableParts() const;
     
@@ -49,13 +72,26 @@ private:
     // 从复合形状中移除可三角剖分的部分
     void removeMeshableFromCompound(const TopoDS_Compound& inputCompound, TopoDS_Compound& outputCompound);
     
+    // 形状分类后按有限内存模式/内存上限释放三角剖分
+    void releaseTriangulation(const TopoDS_Shape& shape);
+    
     // 三角剖分参数
     double deflection_;
     double angle_;
     
+    // 单个形状三角剖分预算
+    double timeLimit_;
+    double memoryLimit_;
+    
+    // 三角剖分内存控制
+    bool releaseTriangulation_;
+    MemoryCeiling memoryCeiling_;
+    
     // 统计信息
     int meshableCount_;
     int nonMeshableCount_;
+    int timedOutCount_;
+    int meshAttemptCount_;
     
     // 存储结果
     TopoDS_Compound meshableParts_;
@@ -6,6 +6,9 @@
 #include <TopAbs_ShapeEnum.hxx>
 #include <Standard_Real.hxx>
 #include <TopTools_DataMapOfShapeInteger.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
+#include <NCollection_DataMap.hxx>
+#include <ShapeBuild_ReShape.hxx>
 #include <string>
 #include <vector>
 #include <map>
@@ -14,7 +17,9 @@
 class TopoDS_Face;
 class TopoDS_Solid;
 class TopoDS_Shell;
+class TopoDS_Edge;
 class Poly_Triangulation;
+class AnalysisRecordWriter;
 
 /**
  * @enum MeshFailureReason
@@ -32,6 +37,7 @@ enum MeshFailureReason {
     NON_MANIFOLD,           ///< Shape is non-manifold
     COMPLEX_CURVE,          ///< Contains complex curves (e.g., B-spline)
     UNSUPPORTED_SURFACE,    ///< Contains unsupported surface types
+    TIMEOUT,                ///< Meshing exceeded its time or memory budget
     OTHER_REASON            ///< Other unspecified reasons
 };
 
@@ -132,6 +138,9 @@ public:
         int facesProcessed;                         ///< Number of faces processed
         int solidsProcessed;                        ///< Number of solids processed
         int shellsProcessed;                        ///< Number of shells processed
+        int reusedOutcomes;                         ///< Shapes classified from the previous run's outcomes
+        int meshAttempts;                           ///< Number of BRepMesh invocations
+        int meshedTriangles;                        ///< Triangles of the shapes classified meshable
         std::map<MeshFailureReason, int> failureCounts; ///< Count of failures by reason
     };
 
@@ -152,9 +161,67 @@ public:
     void EnableCaching(bool enable) { useCache_ = enable; }
     bool IsCachingEnabled() const { return useCache_; }
 
+    /**
+     * @brief Enables/disables edge length metrics (min/max edge length, degenerate edges).
+     * Disabling skips curve-length integration entirely, which is useful for
+     * throughput runs that only need the meshable/non-meshable compounds.
+     */
+    void EnableEdgeMetrics(bool enable) { computeEdgeMetrics_ = enable; }
+    bool IsEdgeMetricsEnabled() const { return computeEdgeMetrics_; }
+
+    /**
+     * @brief Sets a writer that receives one JSON-lines record per classified shape
+     * plus a summary record at the end of Separate(). Pass nullptr to disable.
+     * The writer is not owned and must outlive the calls to Separate().
+     */
+    void SetRecordWriter(AnalysisRecordWriter* writer) { recordWriter_ = writer; }
+
+    /**
+     * @brief Enables/disables accumulation of ShapeAnalysisInfo in GetMeshableInfo()/GetNonMeshableInfo().
+     * Disable together with SetRecordWriter() to stream results in bounded memory.
+     */
+    void SetKeepShapeInfo(bool keep) { keepShapeInfo_ = keep; }
+    bool IsKeepShapeInfo() const { return keepShapeInfo_; }
+
+    /**
+     * @brief Sets the per-shape meshing budget.
+     * A shape whose meshing exceeds either budget is classified as TIMEOUT and the run continues.
+     * @param seconds Maximum wall time per meshing attempt (<= 0 disables)
+     */
+    void SetTimeLimit(double seconds) { timeLimitSeconds_ = seconds; }
+    double GetTimeLimit() const { return timeLimitSeconds_; }
+
+    /// @param megabytes Maximum process memory growth per meshing attempt in MiB (<= 0 disables)
+    void SetMemoryLimit(double megabytes) { memoryLimitMB_ = megabytes; }
+    double GetMemoryLimit() const { return memoryLimitMB_; }
+
+    /// Enables/disables progress messages on std::cout
+    void SetVerbose(bool verbose) { verbose_ = verbose; }
+    bool IsVerbose() const { return verbose_; }
+
     /// Clears all internal caches
     void ClearCache();
 
+    /**
+     * @brief Enables/disables incremental re-analysis across Separate() calls.
+     *
+     * When enabled, per-face outcomes are kept between runs together with the
+     * deflection/angle they were obtained with, so a parameter sweep only redoes
+     * the work the new parameters can change:
+     *  - faces meshed at a finer-or-equal tolerance are reused as meshable;
+     *  - faces meshed at a coarser tolerance are re-meshed (BRepMesh refines the existing mesh);
+     *  - faces that failed validation are reused as non-meshable (tolerance independent);
+     *  - faces that failed meshing at a coarser-or-equal tolerance are reused as non-meshable,
+     *    faces that failed at a finer tolerance are retried;
+     *  - solids/shells whose faces are all known are classified without a meshing attempt.
+     * Timeouts are always retried.
+     */
+    void EnableIncrementalAnalysis(bool enable) { incrementalAnalysis_ = enable; }
+    bool IsIncrementalAnalysisEnabled() const { return incrementalAnalysis_; }
+
+    /// Discards the per-face outcomes kept for incremental re-analysis
+    void ClearHistory();
+
 private:
     // ========== Configuration Parameters ==========
     double deflection_;          ///< Chordal deflection for meshing
@@ -163,12 +230,21 @@ private:
     bool parallel_;              ///< Parallel processing flag
     bool tryFixBeforeMeshing_;   ///< Attempt geometry repair before meshing
     bool useCache_;              ///< Enable result caching for performance
+    bool computeEdgeMetrics_;    ///< Compute edge lengths during shape analysis
+    bool keepShapeInfo_;         ///< Accumulate ShapeAnalysisInfo results
+    bool verbose_;               ///< Print progress messages
+    double timeLimitSeconds_;    ///< Per-shape meshing time budget (<= 0: unlimited)
+    double memoryLimitMB_;       ///< Per-shape meshing memory budget (<= 0: unlimited)
+    bool incrementalAnalysis_;   ///< Reuse per-face outcomes across Separate() calls
+    AnalysisRecordWriter* recordWriter_; ///< Optional streaming output (not owned)
 
     // ========== Results Storage ==========
     TopoDS_Compound meshableParts_;      ///< Compound of meshable shapes
     TopoDS_Compound nonMeshableParts_;   ///< Compound of non-meshable shapes
     std::vector<ShapeAnalysisInfo> meshableInfo_;     ///< Info for meshable shapes
     std::vector<ShapeAnalysisInfo> nonMeshableInfo_;  ///< Info for non-meshable shapes
+    int meshableCount_;                  ///< Number of shapes added to meshableParts_
+    int nonMeshableCount_;               ///< Number of shapes added to nonMeshableParts_
     Statistics stats_;                   ///< Processing statistics
 
     // ========== Cache Implementation ==========
@@ -176,6 +252,32 @@ private:
     TopTools_DataMapOfShapeInteger meshableCache_;     ///< Shape -> 1=meshable, 0=non-meshable
     TopTools_DataMapOfShapeInteger failureCache_;      ///< Shape -> failure reason code
 
+    /**
+     * @struct EdgeMetrics
+     * @brief Memoized per-edge analysis result, shared by every face containing the edge.
+     */
+    struct EdgeMetrics {
+        double length;                      ///< Curve length (0 if not computable)
+        MeshFailureReason failureReason;    ///< SUCCESS if the edge is valid
+        const char* reasonDescription;      ///< Failure description (nullptr on success)
+        bool isComplexCurve;                ///< True for B-spline/Bezier/offset/other curves
+    };
+    NCollection_DataMap<TopoDS_Shape, EdgeMetrics, TopTools_ShapeMapHasher> edgeMetricsCache_; ///< Edge -> metrics
+
+    /**
+     * @struct FaceOutcome
+     * @brief Outcome of a face in a previous run, used for incremental re-analysis.
+     */
+    struct FaceOutcome {
+        double deflection;              ///< Deflection the outcome was obtained with
+        double angle;                   ///< Angle the outcome was obtained with
+        bool relative;                  ///< Relative deflection flag of that run
+        bool meshable;                  ///< True if the face was meshable
+        MeshFailureReason reason;       ///< Recorded failure reason
+        int triangleCount;              ///< Number of triangles of the face
+    };
+    NCollection_DataMap<TopoDS_Shape, FaceOutcome, TopTools_ShapeMapHasher> faceHistory_; ///< Face -> last outcome
+
     // ========== Core Processing Methods ==========
 
     /**
@@ -190,9 +292,53 @@ private:
      * @brief Attempts to mesh a shape and records the outcome.
      * @param shape Shape to attempt meshing on
      * @param info Analysis info structure to populate with results
+     * @param fixContext Optional output: replacements made by the repair before meshing;
+     *                   null when the original shape was meshed
      * @return True if meshing succeeded
      */
-    bool TryMeshing(const TopoDS_Shape& shape, ShapeAnalysisInfo& info);
+    bool TryMeshing(const TopoDS_Shape& shape, ShapeAnalysisInfo& info,
+                    Handle(ShapeBuild_ReShape)* fixContext = nullptr);
+
+    /**
+     * @brief Classifies a SOLID/SHELL, from the face history when possible, otherwise by meshing.
+     * @param shape Solid or shell to classify
+     * @param info Analysis info structure to populate with results
+     * @return True if the shape is meshable
+     */
+    bool MeshOrPredict(const TopoDS_Shape& shape, ShapeAnalysisInfo& info);
+
+    // ========== Incremental Re-analysis ==========
+
+    /// Prediction of a shape's meshability from the face history
+    enum HistoryPrediction {
+        PREDICT_UNKNOWN = 0,        ///< At least one face has to be (re)meshed
+        PREDICT_MESHABLE,           ///< All faces are known meshable at the current tolerance
+        PREDICT_NON_MESHABLE        ///< At least one face is known non-meshable
+    };
+
+    /**
+     * @brief Looks up a face in the history and decides whether its outcome still holds.
+     * @param face Face to look up
+     * @param meshable Output: reused meshability
+     * @param reason Output: reused failure reason
+     * @param triangleCount Output: reused triangle count
+     * @return True if the previous outcome can be reused at the current parameters
+     */
+    bool ReuseFaceOutcome(const TopoDS_Face& face, bool& meshable, MeshFailureReason& reason, int& triangleCount) const;
+
+    /// Predicts a shape's meshability from the outcomes of its faces
+    HistoryPrediction PredictFromHistory(const TopoDS_Shape& shape, int& triangleCount) const;
+
+    /// Records the outcome of a face at the current parameters
+    void RecordFaceOutcome(const TopoDS_Face& face, bool meshable, MeshFailureReason reason, int triangleCount);
+
+    /**
+     * @brief Records every face of a successfully meshed shape as meshable.
+     * @param shape Original shape; its faces key the history
+     * @param fixContext Repair replacements from TryMeshing; the triangles are counted on
+     *                   the face that was actually meshed. Null if the shape was meshed as is.
+     */
+    void RecordMeshedFaces(const TopoDS_Shape& shape, const Handle(ShapeBuild_ReShape)& fixContext);
 
     // ========== Decomposition Methods ==========
 
@@ -239,10 +385,18 @@ private:
      */
     bool CheckEdgeValidity(const TopoDS_Shape& edge, ShapeAnalysisInfo& info);
 
+    /**
+     * @brief Returns the metrics of an edge, computing them on first access only.
+     * @param edge Edge to measure
+     * @return Memoized metrics for the edge
+     */
+    const EdgeMetrics& GetEdgeMetrics(const TopoDS_Edge& edge);
+
     // ========== Geometry Repair Methods ==========
 
-    /// Attempts to repair topological issues in a shape
-    TopoDS_Shape TryFixShape(const TopoDS_Shape& shape);
+    /// Attempts to repair topological issues in a shape; context receives the replacements
+    /// made when the shape was changed
+    TopoDS_Shape TryFixShape(const TopoDS_Shape& shape, Handle(ShapeBuild_ReShape)* context = nullptr);
 
     /// Attempts to repair issues in a specific face
     TopoDS_Face TryFixFace(const TopoDS_Face& face);
@@ -266,6 +420,21 @@ private:
      */
     void AddToCache(const TopoDS_Shape& shape, bool isMeshable, MeshFailureReason reason = SUCCESS);
 
+    // ========== Result Output ==========
+
+    /**
+     * @brief Adds a classified shape to the output compound and records its analysis info.
+     * @param info Analysis info of the shape (info.shape is added to the compound)
+     * @param isMeshable True to add to the meshable parts
+     */
+    void StoreResult(const ShapeAnalysisInfo& info, bool isMeshable);
+
+    /// Writes a per-shape record to the record writer
+    void WriteShapeRecord(const ShapeAnalysisInfo& info, bool isMeshable);
+
+    /// Writes the end-of-run summary record to the record writer
+    void WriteSummaryRecord(bool processingSuccess);
+
     // ========== Statistics and Reporting ==========
 
     /// Updates statistics counters
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Message_ProgressIndicator.hxx>
+#include <Message_ProgressScope.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <TopoDS_Shape.hxx>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class MeshingWatchdog
+ * @brief Progress indicator enforcing a time and memory budget on a single meshing attempt.
+ *
+ * BRepMesh polls Message_ProgressIndicator::UserBreak() at its progress checkpoints
+ * (per face and inside the Delaunay refinement), so returning true from UserBreak()
+ * cancels a pathological face without killing the whole run. Cancellation is
+ * cooperative: the budget is enforced at the next checkpoint, not instantly.
+ *
+ * One watchdog is meant to be created per meshing attempt:
+ * @code
+ *   Handle(MeshingWatchdog) watchdog = new MeshingWatchdog(10.0, 2048.0);
+ *   bool done = watchdog->Mesh(shape, params);
+ *   if (watchdog->IsBudgetExceeded()) { ... }
+ * @endcode
+ */
+class MeshingWatchdog : public Message_ProgressIndicator {
+    DEFINE_STANDARD_RTTI_INLINE(MeshingWatchdog, Message_ProgressIndicator)
+public:
+    /// Budget state of the attempt
+    enum Status {
+        WITHIN_BUDGET = 0,  ///< No limit was hit
+        TIME_EXCEEDED,      ///< Wall time limit was hit
+        MEMORY_EXCEEDED     ///< Memory growth limit was hit
+    };
+
+    /**
+     * @brief Constructor
+     * @param timeLimitSeconds Maximum wall time of the attempt (<= 0 disables)
+     * @param memoryLimitMB Maximum process memory growth during the attempt in MiB (<= 0 disables)
+     */
+    MeshingWatchdog(double timeLimitSeconds, double memoryLimitMB);
+
+    /// Returns true if at least one budget is enabled
+    bool IsEnabled() const { return timeLimitSeconds_ > 0.0 || memoryLimitMB_ > 0.0; }
+
+    /**
+     * @brief Meshes a shape under the watchdog's budget
+     * @param shape Shape to mesh
+     * @param params Meshing parameters
+     * @return True if BRepMesh completed (false on failure or cancellation)
+     */
+    bool Mesh(const TopoDS_Shape& shape, const IMeshTools_Parameters& params);
+
+    /// Polled by the meshing algorithm; returns true once a budget is exceeded
+    Standard_Boolean UserBreak() override;
+
+    /// No visual progress output
+    void Show(const Message_ProgressScope& theScope, const Standard_Boolean isForce) override;
+
+    Status GetStatus() const { return static_cast<Status>(status_.load()); }
+    bool IsBudgetExceeded() const { return GetStatus() != WITHIN_BUDGET; }
+
+    /// Returns a human-readable description of the exceeded budget
+    std::string GetStatusDescription() const;
+
+    /// Returns elapsed wall time in seconds since construction
+    double GetElapsedSeconds() const;
+
+    /// Returns current process working set in MiB (0 if unavailable)
+    static double CurrentMemoryMB();
+
+private:
+
+    double timeLimitSeconds_;
+    double memoryLimitMB_;
+    double baselineMemoryMB_;
+    std::chrono::steady_clock::time_point start_;
+    std::atomic<int> status_;
+
+    // Memory sampling is comparatively expensive, so it is throttled and done by one thread at a time
+    std::mutex memoryMutex_;
+    std::atomic<long long> lastMemoryCheckMs_;
+};
+
+/**
+ * @class MemoryCeiling
+ * @brief Releases the triangulations of classified shapes once the process working set
+ *        exceeds a ceiling.
+ *
+ * Classified shapes are collected until the next memory sample. Memory is sampled on the
+ * first shape of a run, then every few shapes or after a short interval, whichever comes
+ * first. Above the threshold the collected shapes are cleaned with BRepTools::Clean. Freed
+ * memory mostly stays with the process, so the next threshold is set a margin above the
+ * level measured after the release.
+ */
+class MemoryCeiling {
+public:
+    MemoryCeiling();
+
+    /// Sets the ceiling in MiB (<= 0 disables)
+    void SetCeiling(double megabytes);
+    double GetCeiling() const { return ceilingMB_; }
+
+    /// Starts a run: forgets collected shapes and resets the threshold and release count
+    void Reset();
+
+    /// Collects a classified shape and releases the collected triangulations above the threshold
+    void Add(const TopoDS_Shape& shape);
+
+    /// Returns the number of releases forced since the last Reset()
+    int GetForcedReleaseCount() const { return forcedReleaseCount_; }
+
+private:
+    double ceilingMB_;
+    double thresholdMB_;                        // Working set that forces the next release
+    int forcedReleaseCount_;
+    int addedSinceSample_;                      // -1 until the first sample of a run
+    std::chrono::steady_clock::time_point lastSample_;
+    std::vector<TopoDS_Shape> pending_;         // Shapes collected since the last release
+};
@@ -3,6 +3,9 @@
 #include <AIS_InteractiveContext.hxx>
 #include <V3d_View.hxx>
 #include <TopoDS_Shape.hxx>
+#include <Bnd_Box.hxx>
+#include <AIS_Shape.hxx>
+#include <QMap>
 #include <WNT_Window.hxx>
 
 class OccWidget : public QWidget
@@ -17,6 +20,11 @@ public:
     void fitAll();
     void eraseAll();
 
+    // 渐进加载时的包围盒占位：先显示线框盒，形状就绪后替换
+    void displayPlaceholder(int key, const Bnd_Box& box);
+    void replacePlaceholder(int key, const TopoDS_Shape& shape);
+    void clearPlaceholders();
+
 protected:
     void showEvent(QShowEvent* event) override;
     void paintEvent(QPaintEvent* event) override;
@@ -37,6 +45,7 @@ private:
     Handle(V3d_View) m_view;
     Handle(AIS_InteractiveContext) m_context;
     Handle(WNT_Window) m_wntWindow;
+    QMap<int, Handle(AIS_Shape)> m_placeholders;
 
     QPoint m_lastMousePos;
     bool m_isRotating;
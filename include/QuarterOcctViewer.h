@@ -3,12 +3,17 @@
 #include <QMainWindow>
 #include <QWidget>
 #include <QVBoxLayout>
+#include <memory>
 #include <string>
 
+#include "ShapePicker.h"
+#include "ShapeUtil.h"
+
 // Forward declarations for Coin3D and Quarter
 class SoNode;
 class SoSeparator;
 class SoPerspectiveCamera;
+class SoSwitch;
 namespace SIM {
 namespace Coin3D {
 namespace Quarter {
@@ -18,7 +23,9 @@ namespace Quarter {
 }
 
 class QSlider;
+class QLabel;
 class QWheelEvent;
+class BackgroundShapeConverter;
 
 // Forward declarations for OCCT
 class TopoDS_Shape;
@@ -61,13 +68,16 @@ public:
     
     /**
      * @brief Display an OCCT shape
+     *
+     * The parts of the shape are tessellated on a worker thread and added to the scene
+     * one by one as they are converted.
      * @param shape The OCCT shape to display
-     * @return true if successful, false otherwise
+     * @return true if the conversion was started, false otherwise
      */
     bool displayShape(const TopoDS_Shape& shape);
     
     /**
-     * @brief Clear the current scene
+     * @brief Clear the current scene and cancel a conversion still in progress
      */
     void clearScene();
     
@@ -88,22 +98,40 @@ public:
      */
     void zoomAll();
     
-
+    /**
+     * @brief Enable/disable level-of-detail tessellation for shapes displayed afterwards
+     * @param enabled true to tessellate every part at several levels chosen by screen size
+     */
+    void setLevelOfDetail(bool enabled);
     
-protected:
     /**
-     * @brief Setup the UI components
+     * @brief Enable/disable the render statistics overlay
+     *
+     * Shapes displayed afterwards are built with the chunk counters; they disable render
+     * caching above the chunks, so statistics are off by default.
+     * @param enabled true to count drawn and culled chunks with every render pass
      */
-    void setupUI();
+    void setRenderStatistics(bool enabled);
     
     /**
-     * @brief Convert OCCT TopoDS_Shape to Coin3D SoNode
-     * @param shape The OCCT shape to convert
-     * @return Converted Coin3D node, or nullptr if conversion failed
+     * @brief Pick the displayed shape at a viewport position
+     *
+     * The pick is answered from a triangle BVH of the shape, built after its conversion,
+     * and returns the face that was hit and the edge of that face under the cursor, if any.
+     * A free edge, including one of a wire-only shape, in front of the face is returned instead.
+     * @param x Viewport X position
+     * @param y Viewport Y position (origin at the bottom)
+     * @return Pick result; hit is false if nothing was hit or the BVH is not built yet
      */
-    SoNode* convertOcctShapeToCoin3D(TopoDS_Shape shape);
+    ShapePicker::PickResult pickShape(int x, int y) const;
+
 
-	SoNode* convertShapeRecursive(TopoDS_Shape shape,double deviation, double angularDeflection);
+    
+protected:
+    /**
+     * @brief Setup the UI components
+     */
+    void setupUI();
     
     /**
      * @brief Read a STEP file and return the shape
@@ -148,6 +176,12 @@ protected:
      */
     void performPick(int x, int y);
     
+    /**
+     * @brief Show the chunk and triangle counts of the last render pass in the overlay
+     * @param stats Statistics gathered while rendering
+     */
+    void updateStatistics(const ShapeUtil::RenderStatistics& stats);
+    
 private slots:
     /**
      * @brief Slot for wireframe checkbox
@@ -182,4 +216,11 @@ private:
     bool m_wireframeMode;                 // Wireframe mode flag
     SoSeparator* m_pickRoot;              // Root for pickable objects
     bool m_pickEnabled;                   // Flag to enable/disable picking
+    bool m_levelOfDetail;                 // Tessellate parts at several levels of detail
+    BackgroundShapeConverter* m_converter; // Converts shapes off the GUI thread
+    QLabel* m_statsLabel;                 // Render statistics overlay
+    SoSwitch* m_statsStart;               // Resets the statistics before a render pass
+    SoSwitch* m_statsEnd;                 // Passes the statistics to the overlay after it
+    std::shared_ptr<const ShapePicker> m_picker; // Triangle BVH of the displayed shape
+    unsigned int m_pickerGeneration;      // Incremented per scene, drops outdated BVHs
 };
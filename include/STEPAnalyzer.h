@@ -7,6 +7,7 @@
 #include <fstream>
 #include <chrono>
 #include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
 #include <STEPControl_Reader.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopAbs_ShapeEnum.hxx>
@@ -15,7 +16,9 @@
 #include <TopTools_HSequenceOfShape.hxx>
 #include <TColStd_HSequenceOfTransient.hxx>
 #include <STEPConstruct.hxx>
-#include <Interface_Static.hxx>
+#include "StepReaderOptions.h"
+
+class AnalysisRecordWriter;
 
 // Entity status definition
 enum class EntityStatus {
@@ -25,6 +28,15 @@ enum class EntityStatus {
     SKIPPED         // Skipped
 };
 
+// Check pipeline tiers, ordered from cheapest to most expensive
+enum CheckTier {
+    TIER_BASIC = 0,             // O(1): null shape, shape type, bounding box sanity
+    TIER_TOPOLOGY,              // Linear: element counts, closure, small edges, manifold check
+    TIER_MESH,                  // Mesh generation test and mass properties
+    TIER_SELF_INTERSECTION,     // On the test mesh: only for meshed, non-manifold shapes
+    CHECK_TIER_COUNT
+};
+
 // Entity information structure
 struct EntityInfo {
     int id;                         // Entity ID
@@ -36,11 +48,17 @@ struct EntityInfo {
     TopoDS_Shape shape;             // Shape object
     double volume;                  // Volume (if applicable)
     double surfaceArea;             // Surface area
+    gp_Pnt centroid;                // Volume centroid (area centroid if the shape has no volume)
+    double volumeErrorBound;        // Upper estimate of |volume error| (0 if computed exactly)
     bool isManifold;                // Whether it's manifold
     bool isClosed;                  // Whether it's closed
     int faceCount;                  // Face count
     int edgeCount;                  // Edge count
     int vertexCount;                // Vertex count
+    std::vector<std::pair<int, int>> selfIntersectingFaces; // Intersecting face pairs (1-based face indices)
+    int deepestTier;                // Last check tier reached (-1 if none)
+    int rejectedAtTier;             // Tier that rejected the entity (-1 if none)
+    double tierTime[CHECK_TIER_COUNT]; // Time spent in each tier (seconds)
 };
 
 // Analysis result structure
@@ -54,9 +72,22 @@ struct AnalysisResult {
     int successfulMeshCount = 0;
     double processingTime = 0.0;
 
+    // Status counts (kept even when entities are streamed out instead of stored)
+    int exportableCount = 0;
+    int problematicCount = 0;
+    int unsupportedCount = 0;
+    int skippedCount = 0;
+    double totalVolume = 0.0;
+    double totalVolumeErrorBound = 0.0;
+
     // Statistics
     std::map<std::string, int> entityTypeCount;
     std::map<std::string, std::vector<std::string>> issueCategories;
+
+    // Check pipeline statistics, indexed by CheckTier
+    int tierEntityCount[CHECK_TIER_COUNT] = {};
+    int tierRejectCount[CHECK_TIER_COUNT] = {};
+    double tierTime[CHECK_TIER_COUNT] = {};
 };
 
 class STEPAnalyzer {
@@ -67,9 +98,14 @@ public:
     // Load STEP file
     bool LoadSTEP(const std::string& filepath);
 
-    // Analyze all entities
+    // Analyze all entities (quick mode skips volume/area and self-intersection checks);
+    // root compounds are expanded, so every part of an assembly is one entity
     AnalysisResult Analyze(bool quickMode = false);
 
+    // Analyze a STEP file one root at a time, writing one record per part instead of
+    // keeping shapes in memory; the result only holds statistics afterwards
+    bool AnalyzeStreaming(const std::string& filepath, AnalysisRecordWriter& writer, bool quickMode = false);
+
     // Analyze single entity
     EntityInfo AnalyzeEntity(const TopoDS_Shape& shape, int entityId);
 
@@ -93,20 +129,39 @@ public:
     // Set whether to auto fix issues
     void SetAutoFix(bool autoFix) { m_autoFix = autoFix; }
 
+    // Set whether mass properties are integrated over the mesh-test triangulation instead of the exact surfaces
+    void SetFastMassProperties(bool fast) { m_fastMassProperties = fast; }
+
+    // Set whether entities are analyzed in parallel (one task per independent entity group)
+    void SetParallel(bool parallel) { m_parallel = parallel; }
+
+    // Set STEP read parameters used by this analyzer's readers
+    void SetReaderOptions(const StepReaderOptions& options) { m_readerOptions = options; }
+
+    // Set whether LoadSTEP transfers independent roots on worker threads
+    void SetParallelTransfer(bool parallel) { m_parallelTransfer = parallel; }
+
 private:
     // Internal methods
-    bool CheckExportability(const TopoDS_Shape& shape, EntityInfo& info);
+    static void ExpandToParts(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& parts);
+    std::vector<EntityInfo> AnalyzeEntities(const std::vector<TopoDS_Shape>& shapes);
+    EntityInfo AnalyzeEntityIsolated(const TopoDS_Shape& shape, int entityId);
+    std::vector<int> GroupEntitiesBySharedFaces(const std::vector<TopoDS_Shape>& shapes, int& groupCount);
+    void MergeEntity(const EntityInfo& info, bool keepEntity = true);
+    void WriteEntityRecord(AnalysisRecordWriter& writer, const EntityInfo& info, int rootIndex) const;
+    void InitEntityInfo(EntityInfo& info, const TopoDS_Shape& shape, int entityId);
+    bool CheckBasic(const TopoDS_Shape& shape, EntityInfo& info);
+    bool CheckTopology(const TopoDS_Shape& shape, EntityInfo& info);
     bool PerformMeshTest(const TopoDS_Shape& shape, EntityInfo& info);
     bool CheckManifold(const TopoDS_Shape& shape);
     bool CheckClosed(const TopoDS_Shape& shape);
-    double CalculateVolume(const TopoDS_Shape& shape);
-    double CalculateSurfaceArea(const TopoDS_Shape& shape);
+    void ComputeMassProperties(const TopoDS_Shape& shape, EntityInfo& info);
     void CountElements(const TopoDS_Shape& shape, EntityInfo& info);
     std::string GetSTEPEntityName(int entityId);
     TopAbs_ShapeEnum GetShapeType(const TopoDS_Shape& shape);
     bool IsSupportedType(TopAbs_ShapeEnum shapeType);
     bool HasValidGeometry(const TopoDS_Shape& shape);
-    bool CheckSelfIntersection(const TopoDS_Shape& shape);
+    bool CheckSelfIntersection(const TopoDS_Shape& shape, EntityInfo& info);
     bool CheckSmallEdges(const TopoDS_Shape& shape, double tolerance = 1e-6);
 
     // Fix methods
@@ -118,7 +173,9 @@ private:
     STEPControl_Reader m_reader;
     TopoDS_Shape m_rootShape;
     Handle(TColStd_HSequenceOfTransient) m_entitySequence;
+    std::vector<TopoDS_Shape> m_transferredShapes;  // Per-entity shapes of a parallel transfer
     AnalysisResult m_result;
+    StepReaderOptions m_readerOptions;
 
     // Configuration
     double m_linearDeflection;
@@ -126,5 +183,9 @@ private:
     bool m_relativeMode;
     bool m_includeSurfaces;
     bool m_autoFix;
+    bool m_parallel;
+    bool m_parallelTransfer;
+    bool m_quickMode;
+    bool m_fastMassProperties;
     bool m_loaded;
 };
\ No newline at end of file
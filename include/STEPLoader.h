@@ -2,18 +2,34 @@
 #include <QObject>
 #include <QString>
 #include <vector>
+#include <functional>
+#include <Bnd_Box.hxx>
 #include <TopoDS_Shape.hxx>
 #include <STEPControl_Reader.hxx>
+#include <Prs3d_Drawer.hxx>
+#include "StepReaderOptions.h"
 
 class STEPLoader : public QObject
 {
     Q_OBJECT
 
 public:
+    /// 渐进加载回调，在加载线程中调用；每个根实体先报告包围盒，网格化完成后再报告形状。
+    /// 启用并行转换时全部根实体转换完成后才开始回调
+    struct ProgressiveCallbacks {
+        std::function<void(int rootIndex, int rootCount, const Bnd_Box& box)> rootTransferred;
+        std::function<void(int rootIndex, int rootCount, const TopoDS_Shape& shape)> rootReady;
+    };
+
     explicit STEPLoader(QObject* parent = nullptr);
     bool loadSTEPFile(const QString& filePath, bool enableFix = false);
+    bool loadSTEPFileProgressive(const QString& filePath, const ProgressiveCallbacks& callbacks);
     void setEnableFix(bool enable) { m_enableFix = enable; }
     bool isEnableFix() const { return m_enableFix; }
+    void setParallelTransfer(bool enable) { m_parallelTransfer = enable; }
+    bool isParallelTransfer() const { return m_parallelTransfer; }
+    void setReaderOptions(const StepReaderOptions& options) { m_readerOptions = options; }
+    const StepReaderOptions& getReaderOptions() const { return m_readerOptions; }
     const std::vector<TopoDS_Shape>& getShapes() const { return m_shapes; }
 
     signals:
@@ -21,7 +37,10 @@ public:
 
 private:
     TopoDS_Shape fixShape(const TopoDS_Shape& shape);
+    void meshUntriangulatedFaces(const TopoDS_Shape& shape, const Handle(Prs3d_Drawer)& drawer);
     STEPControl_Reader m_reader;
     std::vector<TopoDS_Shape> m_shapes;
     bool m_enableFix; ///< 是否启用形状修复工具
+    bool m_parallelTransfer; ///< 是否在工作线程上并行转换各根实体
+    StepReaderOptions m_readerOptions; ///< 仅作用于本读取器的STEP读取参数
 };
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <TopoDS_Shape.hxx>
 #include <vector>
 #include <string>
+#include <functional>
+
+class AnalysisRecordWriter;
 
 // 诊断结果结构体
 struct MeshDiagnosis {
@@ -25,6 +28,12 @@ public:
     // 从STEP文件读取并诊断所有形状
     bool diagnoseStepFile(const std::string& filename, std::vector<MeshDiagnosis>& outDiagnoses);
     
+    // 流式诊断：每诊断完一个实体立即写出一条JSON记录，不保存诊断结果，返回可导出实体数
+    int diagnoseShape(const TopoDS_Shape& aShape, AnalysisRecordWriter& writer);
+    
+    // 流式诊断STEP文件：逐个转换根实体，诊断后立即写出记录并释放
+    bool diagnoseStepFile(const std::string& filename, AnalysisRecordWriter& writer);
+    
     // 获取可导出的形状
     std::vector<TopoDS_Shape> getExportableShapes(const std::vector<MeshDiagnosis>& diagnoses) const;
     
@@ -46,12 +55,30 @@ public:
     // 获取网格化精度
     double getDeflection() const;
     
+    // 设置单个实体网格化的时间预算（秒，<=0表示不限制），超出后判定为超时并继续诊断
+    void setTimeLimit(double seconds);
+    
+    // 设置单个实体网格化的内存增长预算（MiB，<=0表示不限制）
+    void setMemoryLimit(double megabytes);
+    
+    // 获取自构造以来网格化尝试的次数
+    int getMeshAttemptCount() const;
+    
 private:
+    // 诊断结果回调
+    using DiagnosisSink = std::function<void(MeshDiagnosis&&)>;
+    
     // 分解模型并独立诊断
     std::vector<MeshDiagnosis> diagnoseAndMeshShapes(const TopoDS_Shape& aShape);
     
+    // 分解模型并将每个诊断结果交给回调，返回诊断的实体数
+    int diagnoseAndMeshShapes(const TopoDS_Shape& aShape, const DiagnosisSink& sink);
+    
     // 递归分解形状的辅助函数
-    void recursiveDiagnose(const TopoDS_Shape& aShape, std::vector<MeshDiagnosis>& results);
+    void recursiveDiagnose(const TopoDS_Shape& aShape, const DiagnosisSink& sink, int& count);
+    
+    // 写出单个诊断结果的JSON记录
+    void writeDiagnosisRecord(AnalysisRecordWriter& writer, const MeshDiagnosis& diag, int index, int rootIndex) const;
     
     // 从STEP文件读取并诊断所有形状
     bool readStepAsSeparateShapes(const std::string& filename, std::vector<TopoDS_Shape>& outShapes) const;
@@ -61,6 +88,9 @@ private:
     
     // 成员变量
     double myDeflection; // 网格化精度
+    double myTimeLimit; // 单个实体网格化时间预算（秒）
+    double myMemoryLimit; // 单个实体网格化内存预算（MiB）
+    int myMeshAttemptCount; // 网格化尝试次数
 };
 
 #endif // STLEXPORTDIAGNOSER_H
\ No newline at end of file
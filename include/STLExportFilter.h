@@ -3,6 +3,9 @@
 #include <TopoDS_Shape.hxx>
 #include <TopoDS_Compound.hxx>
 #include <Standard_Real.hxx>
+#include <vector>
+
+#include "MeshingWatchdog.h"
 
 class STLExportFilter {
 public:
@@ -30,6 +33,38 @@ public:
      */
     void setDeflection(double deflection);
 
+    /**
+     * @brief Enable bounded-memory mode
+     *
+     * Triangulations created while probing stay attached to the input shape's faces.
+     * When enabled, they are removed with BRepTools::Clean as soon as a sub-shape is
+     * classified, so the output compounds must be re-meshed before writing STL.
+     * @param release True to release triangulations after classification
+     */
+    void setReleaseTriangulation(bool release);
+
+    /**
+     * @brief Set process memory ceiling
+     *
+     * The process working set is sampled on the first classified shape, then every few
+     * shapes or after a short interval (see MemoryCeiling). When it exceeds
+     * the ceiling, triangulations of the shapes classified since the previous release
+     * are released, and the next release waits until memory grows again by a margin
+     * over the level measured after this one.
+     * @param megabytes Memory ceiling in MiB (<= 0 disables)
+     */
+    void setMemoryCeiling(double megabytes);
+
+    /**
+     * @brief Get the number of releases forced by the memory ceiling in the last run
+     */
+    int getForcedReleaseCount() const;
+
+    /**
+     * @brief Get the number of meshing attempts in the last run
+     */
+    int getMeshAttemptCount() const;
+
 private:
     /**
      * @brief Check if a shape can be exported to STL
@@ -62,5 +97,14 @@ private:
                               TopoDS_Compound& exportableParts, 
                               TopoDS_Compound& nonExportableParts);
 
+    /**
+     * @brief Release triangulations after a shape has been classified
+     * @param shape Classified shape
+     */
+    void releaseTriangulation(const TopoDS_Shape& shape);
+
     double deflection_; ///< Linear deflection for meshing
+    bool releaseTriangulation_; ///< Release triangulations after classification
+    MemoryCeiling memoryCeiling_; ///< Releases triangulations above the process memory ceiling
+    int meshAttemptCount_; ///< Meshing attempts in the last run
 };
@@ -2,9 +2,13 @@
 #define STLMULTILEVELEXPORTER_H
 
 #include <TopoDS_Shape.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopAbs_ShapeEnum.hxx>
 #include <vector>
 #include <string>
 
+class AnalysisRecordWriter;
+
 struct ExportResult {
     TopoDS_Shape shape;
     std::string shapeLevel;
@@ -14,6 +18,15 @@ struct ExportResult {
     std::string failureReason;
 };
 
+// 失败形状的分解策略
+enum class DecompositionStrategy {
+    TOP_DOWN,   // 逐个子形状重新网格化（每个子形状一次网格化尝试）
+    BISECTION   // 对子形状列表二分网格化，仅对失败的一半继续细分，复用成功一半的三角化结果
+};
+
+// 将TopAbs_ShapeEnum转换为字符串（如"SOLID"），供导出报告和分析记录使用
+std::string shapeTypeToString(TopAbs_ShapeEnum shapeType);
+
 class STLMultiLevelExporter {
 public:
     explicit STLMultiLevelExporter(double deflection = 0.01);
@@ -45,22 +58,65 @@ public:
     // 获取总形状数量
     int getTotalShapeCount() const;
     
+    // 设置流式JSON记录输出（不持有，传入nullptr关闭）
+    void setRecordWriter(AnalysisRecordWriter* writer);
+    
+    // 设置是否保存ExportResult（关闭后配合记录输出可在有限内存下批量分析）
+    void setKeepResults(bool keep);
+    
+    // 设置失败形状的分解策略
+    void setDecompositionStrategy(DecompositionStrategy strategy);
+    DecompositionStrategy getDecompositionStrategy() const;
+    
+    // 获取上次分析中网格化尝试的次数
+    int getMeshAttemptCount() const;
+    
 private:
     // 递归分解形状
     void decomposeShape(const TopoDS_Shape& shape, const std::string& currentLevel, std::vector<ExportResult>& results);
     
+    // 分解失败形状的子形状（按当前策略），meshed表示该形状已网格化完成、仅覆盖率不足
+    void decomposeChildren(const TopoDS_Shape& shape, bool meshed, std::vector<ExportResult>& results);
+    
+    // 获取下一级子形状及其级别名称，返回false表示不可再分解
+    bool getChildShapes(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& children, std::string& childLevel) const;
+    
+    // 二分定位子形状列表[first, last)中失败的子形状
+    void bisectShapes(const std::vector<TopoDS_Shape>& shapes, size_t first, size_t last,
+                      const std::string& level, std::vector<ExportResult>& results);
+    
+    // 按已有三角化的覆盖率分类子形状列表[first, last)，覆盖率不足的继续分解
+    void classifyMeshedShapes(const std::vector<TopoDS_Shape>& shapes, size_t first, size_t last,
+                              const std::string& level, std::vector<ExportResult>& results);
+    
+    // 将子形状列表[first, last)作为一个整体网格化，返回网格化是否完成
+    bool meshGroup(const std::vector<TopoDS_Shape>& shapes, size_t first, size_t last);
+    
+    // 记录单个形状的结果（计数、导出复合体、记录输出）
+    void recordResult(const ExportResult& result, std::vector<ExportResult>& results);
+    
     // 尝试导出单个形状到STL
     bool tryExportShape(const TopoDS_Shape& shape, ExportResult& result);
     
     // 检查形状是否可三角化
     bool isTriangulable(const TopoDS_Shape& shape);
     
-    // 计算形状的三角化覆盖率
-    double calculateTriangulationCoverage(const TopoDS_Shape& shape);
+    // 计算形状的三角化覆盖率，并更新结果中的面计数
+    double calculateTriangulationCoverage(const TopoDS_Shape& shape, ExportResult& result);
+    
+    // 写出单个结果的JSON记录
+    void writeResultRecord(const ExportResult& result, int index);
     
     // 成员变量
     double m_deflection;
     std::vector<ExportResult> m_exportResults;
+    TopoDS_Compound m_exportableParts;
+    int m_successCount;
+    int m_failureCount;
+    int m_meshAttemptCount;
+    bool m_keepResults;
+    DecompositionStrategy m_strategy;
+    AnalysisRecordWriter* m_recordWriter;
     
     // 常量定义
     static const double TRIANGULATION_COVERAGE_THRESHOLD;
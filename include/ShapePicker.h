@@ -0,0 +1,130 @@
+#pragma once
+
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopoDS_Shape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Lin.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+
+/**
+ * @class ShapePicker
+ * @brief Answers ray picks against the triangulation of a displayed shape through a BVH,
+ *        without traversing the Coin3D scene.
+ *
+ * build() collects the triangles of every located face of the shape, in world coordinates,
+ * together with the polylines of the face edges, and builds a bounding volume hierarchy
+ * over the triangles. Every triangle maps back to its face, so a pick returns the
+ * TopoDS_Face that was hit; pickEdge() then looks for an edge of that face near the ray.
+ * Edges that bound no face, including those of wire-only shapes, are kept as polylines of
+ * their 3D polygon and tested one by one by pickFreeEdge().
+ *
+ * The shape must carry the triangulation that is displayed, i.e. build() is called after
+ * the conversion. The picker keeps its own copy of the nodes; it does not follow later
+ * changes of the triangulation. pick() and pickEdge() are const and may run concurrently.
+ *
+ * @code
+ *   ShapePicker picker;
+ *   picker.build(shape);
+ *   ShapePicker::PickResult result = picker.pick(ray);
+ *   if (result.hit && picker.pickEdge(ray, result, tolerance)) { ... result.edge ... }
+ *   picker.pickFreeEdge(ray, result, tolerance, toleranceSlope);
+ * @endcode
+ */
+class ShapePicker {
+public:
+    /// Nearest hit of a ray
+    struct PickResult {
+        bool hit = false;
+        double distance = 0.0;      ///< Ray parameter of the hit point
+        gp_Pnt point;               ///< Hit point in world coordinates
+        gp_Dir normal;              ///< Triangle normal, facing the ray origin
+        int triangle = -1;          ///< Index of the hit triangle
+        int faceIndex = 0;          ///< Index of the face in faces(), 1-based; 0 for a free edge
+        TopoDS_Face face;           ///< Located face that was hit; null for a free edge
+        int edgeIndex = 0;          ///< Index of the edge in edges(), 1-based; 0 if none
+        TopoDS_Edge edge;           ///< Located edge near the ray, set by pickEdge() or pickFreeEdge()
+    };
+
+    ShapePicker();
+
+    /**
+     * @brief Collects the triangles and edge polylines of the shape and builds the BVH
+     * @param shape Shape whose faces are triangulated
+     * @return Number of triangles
+     */
+    int build(const TopoDS_Shape& shape);
+
+    /// Drops all triangles
+    void clear();
+
+    /**
+     * @brief Finds the nearest triangle in front of the ray origin
+     * @param ray Pick ray in world coordinates
+     * @return Hit with its face, or a result with hit == false
+     */
+    PickResult pick(const gp_Lin& ray) const;
+
+    /**
+     * @brief Finds the edge of the hit face closest to the ray
+     * @param ray Pick ray that produced the result
+     * @param result Hit returned by pick(); edge and edgeIndex are set on success
+     * @param tolerance Maximum distance between the ray and the edge polyline
+     * @return true if an edge lies within the tolerance
+     */
+    bool pickEdge(const gp_Lin& ray, PickResult& result, double tolerance) const;
+
+    /**
+     * @brief Finds the free edge closest to the ray, if it lies in front of the current hit
+     * @param ray Pick ray in world coordinates
+     * @param result Result of pick() and pickEdge(); replaced by the free edge on success
+     * @param tolerance Maximum distance between the ray and the edge polyline at the ray origin
+     * @param toleranceSlope Growth of the tolerance per unit of the ray parameter, 0 for
+     *        parallel projection
+     * @return true if a free edge lies within the tolerance
+     */
+    bool pickFreeEdge(const gp_Lin& ray, PickResult& result, double tolerance, double toleranceSlope) const;
+
+    /// Number of triangles in the hierarchy
+    int triangleCount() const { return static_cast<int>(m_triangleFaces.size()); }
+
+    /// Located faces the triangles map back to
+    const TopTools_IndexedMapOfShape& faces() const { return m_faces; }
+
+    /// Located edges of the faces and free edges
+    const TopTools_IndexedMapOfShape& edges() const { return m_edges; }
+
+private:
+    struct BvhNode {
+        float boxMin[3];
+        float boxMax[3];
+        int left;       // Child node indices, -1 for leaves
+        int right;
+        int first;      // First entry in m_order for leaves
+        int count;      // Number of triangles for leaves, 0 for inner nodes
+    };
+
+    // Polyline of one edge on the triangulation of one face, or of a free edge
+    struct EdgePolyline {
+        int edge;
+        int first;      // First point in m_edgePoints
+        int count;
+    };
+
+    int buildNode(int begin, int end);
+    bool intersectTriangle(int triangle, const double origin[3], const double direction[3], double& distance) const;
+
+    std::vector<float> m_vertices;              // Nine floats per triangle
+    std::vector<int> m_triangleFaces;           // Face index per triangle
+    std::vector<float> m_boxes;                 // Six floats per triangle: min and max
+    std::vector<int> m_order;
+    std::vector<BvhNode> m_nodes;
+
+    TopTools_IndexedMapOfShape m_faces;
+    TopTools_IndexedMapOfShape m_edges;
+    std::vector<std::vector<EdgePolyline>> m_faceEdges;   // Per face, 0-based
+    std::vector<EdgePolyline> m_freeEdges;
+    std::vector<gp_Pnt> m_edgePoints;
+};
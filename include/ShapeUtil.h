@@ -8,14 +8,85 @@
 #include <Inventor/nodes/SoNode.h>
 #include <Inventor/SbColor.h>
 
+#include <vector>
+
+class SoSeparator;
+
 // Shape utility class for OCCT shape conversion
 class ShapeUtil
 {
 public:
+    // One tessellation level of a level-of-detail node
+    struct DetailLevel
+    {
+        double deflection;          // absolute linear deflection
+        double angularDeflection;   // angular deflection in radians
+        float minScreenArea;        // projected bounding box area in pixels from which the level is used
+    };
+
+    // Nodes the face triangles of a chunk are drawn with
+    enum class GeometryFormat
+    {
+        IndexedFaceSet,             // SoIndexedFaceSet over shared coordinates and normals
+        TriangleBuffer              // SoInterleavedTriangleSet with the chunk's own nodes and 16-bit indexes where they fit
+    };
+
+    // Chunks and triangles met by GL rendering since the last resetRenderStatistics()
+    struct RenderStatistics
+    {
+        int chunks = 0;             // chunks in the drawn levels of detail
+        int culledChunks = 0;       // chunks outside the view volume or below the minimum screen area
+        int triangles = 0;
+        int culledTriangles = 0;
+    };
+
     // Convert OCCT shape to Inventor node
     static SoNode* convertShapeRecursive(TopoDS_Shape shape, double deviation = 0.01, double angularDeflection = 0.5, SbColor color = SbColor(0.8, 0.8, 0.8));
     // Convert single OCCT shape to Inventor node
     static SoNode* convertSingleShape(TopoDS_Shape shape, double deviation = 0.01, double angularDeflection = 0.5, SbColor color = SbColor(0.8, 0.8, 0.8));
+    // Mesh the shape with an absolute linear deflection
+    static void meshShape(const TopoDS_Shape& shape, double deflection, double angularDeflection = 0.5);
+    // Convert the existing triangulation of the shape to Inventor nodes; faces are filled in parallel
+    static SoSeparator* convertMeshedShape(const TopoDS_Shape& shape, SbColor color = SbColor(0.8, 0.8, 0.8));
+    // Mesh and convert with an absolute linear deflection; the geometry is cached per shape and
+    // tessellation quality for all viewers, and every display gets its own copy, so displaying a
+    // shape again is cheap and safe from any thread
+    static SoSeparator* convertShape(const TopoDS_Shape& shape, double deflection, double angularDeflection = 0.5, SbColor color = SbColor(0.8, 0.8, 0.8));
+    // Convert with several tessellation levels, finest first, into an SoLevelOfDetail that picks
+    // the level by the projected screen size of the shape; levels are cached like convertShape()
+    static SoNode* convertShapeLevels(const TopoDS_Shape& shape, const std::vector<DetailLevel>& levels, SbColor color = SbColor(0.8, 0.8, 0.8));
+    // Check whether the shape already carries a triangulation at least as fine as the deflection
+    static bool hasValidTriangulation(const TopoDS_Shape& shape, double deflection);
+    // Drop all cached geometry
+    static void clearTessellationCache();
+    // Set the maximum number of triangles in the cached geometry (0 disables the cache)
+    static void setTessellationCacheCapacity(int capacity);
+    // Set the projected bounding box area in pixels below which a chunk is skipped (0 draws all);
+    // applies to geometry built afterwards, so the cache is dropped
+    static void setMinChunkScreenArea(float area);
+    // Set the nodes used for face triangles; applies to geometry built afterwards, so the cache is dropped.
+    // Call it from the thread that initialized Coin, as it registers the triangle buffer node type.
+    static void setGeometryFormat(GeometryFormat format);
+    // Nodes currently used for face triangles
+    static GeometryFormat geometryFormat();
+    // Build chunks with the callbacks that gather render statistics (off by default, as the
+    // callbacks disable render caching); applies to geometry built afterwards, so the cache is dropped
+    static void setRenderStatistics(bool enabled);
+    // Whether geometry is built with render statistics
+    static bool renderStatisticsEnabled();
+    // Reset the render statistics, typically at the start of a frame
+    static void resetRenderStatistics();
+    // Render statistics gathered since the last reset; only GL rendering on the GUI thread updates them
+    static RenderStatistics renderStatistics();
+
+private:
+    // Cached or newly built geometry at one tessellation quality, referenced for the caller to
+    // unref and never shared with the cache; with exactLevel a much finer existing triangulation
+    // is not reused
+    static SoSeparator* tessellate(const TopoDS_Shape& shape, double deflection, double angularDeflection, bool exactLevel);
+    // Build the coordinate, normal, face, line and point nodes of a meshed shape; the faces are
+    // split into spatially coherent chunks that Coin culls by view volume and screen size
+    static SoSeparator* buildGeometry(const TopoDS_Shape& shape);
 };
 
-#endif // SHAPEUTIL_H
\ No newline at end of file
+#endif // SHAPEUTIL_H
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <Inventor/nodes/SoShape.h>
+#include <Inventor/nodes/SoSubNode.h>
+#include <Inventor/SbBox3f.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class SoInterleavedTriangleSet
+ * @brief Triangle list drawn straight from an interleaved normal/position array.
+ *
+ * Every vertex takes six floats, the normal followed by the position (the GL_N3F_V3F
+ * layout), and every triangle three indexes with no end marker. Indexes are stored with
+ * 16 bits when the set has at most 65536 vertices. The arrays are uploaded once per GL
+ * context into vertex buffer objects and drawn with one glDrawElements call; without VBO
+ * support they are drawn as client-side vertex arrays.
+ *
+ * The node ignores the coordinate, normal and binding elements of the state. It uses the
+ * current material, and the draw style through the polygon mode Coin sets. Picking and
+ * bounding boxes work through generatePrimitives() and computeBBox(), and picked points
+ * carry an SoFaceDetail whose face index is the triangle index.
+ *
+ * initClass() must be called after SoDB::init() and before the first node is created.
+ */
+class SoInterleavedTriangleSet : public SoShape {
+    SO_NODE_HEADER(SoInterleavedTriangleSet);
+
+public:
+    /// Registers the node type with Coin; calling it again has no effect
+    static void initClass();
+
+    /// Constructor
+    SoInterleavedTriangleSet();
+
+    /**
+     * @brief Replaces the geometry
+     * @param vertices Six floats per vertex: nx, ny, nz, x, y, z
+     * @param indices Three vertex indexes per triangle
+     */
+    void setGeometry(std::vector<float> vertices, const std::vector<uint32_t>& indices);
+
+    /// Number of vertices
+    int getNumVertices() const { return static_cast<int>(m_vertices.size() / 6); }
+
+    /// Number of triangles
+    int getNumTriangles() const { return m_numIndices / 3; }
+
+    /// Returns true if the indexes are stored with 16 bits
+    bool hasShortIndices() const { return !m_shortIndices.empty(); }
+
+    /// Bytes held by the vertex and index arrays on the CPU side
+    size_t getMemoryUsage() const;
+
+    void GLRender(SoGLRenderAction* action) override;
+
+protected:
+    ~SoInterleavedTriangleSet() override;
+
+    void computeBBox(SoAction* action, SbBox3f& box, SbVec3f& center) override;
+    void generatePrimitives(SoAction* action) override;
+    /// Copies the arrays for SoNode::copy(); the GL buffers stay with the source
+    void copyContents(const SoFieldContainer* from, SbBool copyConnections) override;
+
+private:
+    // Vertex and index buffer objects of one GL context
+    struct ContextBuffers {
+        uint32_t context;
+        unsigned int vertexBuffer;
+        unsigned int indexBuffer;
+    };
+
+    uint32_t vertexIndex(int i) const;
+    void releaseBuffers();
+
+    std::vector<float> m_vertices;
+    std::vector<uint16_t> m_shortIndices;
+    std::vector<uint32_t> m_indices;
+    int m_numIndices;
+    SbBox3f m_box;
+    std::vector<ContextBuffers> m_buffers;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <IFSelect_ReturnStatus.hxx>
+#include <STEPControl_Reader.hxx>
+#include <optional>
+#include <string>
+
+/**
+ * @struct StepReaderOptions
+ * @brief STEP read parameters applied to one reader session instead of the global Interface_Static table.
+ *
+ * Unset fields keep the process-wide default, so callers only state what they change.
+ * With OCCT 7.8 or newer the parameters travel with the reader's model, so concurrent
+ * loads with different options do not interfere. Older OCCT reads the parameters from
+ * Interface_Static during transfer as well; there ReadFile() writes them under a
+ * process-wide lock, which keeps the writes consistent but cannot isolate a transfer
+ * that is still running in another thread.
+ *
+ * @code
+ *   StepReaderOptions options;
+ *   options.productMode = false;
+ *   options.maxPrecision = 0.01;
+ *   STEPControl_Reader reader;
+ *   if (options.ReadFile(reader, path) == IFSelect_RetDone) { ... }
+ * @endcode
+ */
+struct StepReaderOptions {
+    std::optional<double> maxPrecision;         ///< read.maxprecision.val: maximum tolerance of the result
+    std::optional<bool> productMode;            ///< read.step.product.mode: read the product structure
+    std::optional<bool> nonManifold;            ///< read.step.nonmanifold: keep non-manifold topology
+    std::optional<int> shapeRepresentation;     ///< read.step.shape.repr: representation kinds read (1 = all)
+    std::optional<int> surfaceCurveMode;        ///< read.surfacecurve.mode: 0 default, +/-2 prefer/force 2D, +/-3 prefer/force 3D
+
+    /**
+     * @brief Reads a STEP file into the reader with these options
+     * @param reader Reader to load the file into
+     * @param filePath Path of the STEP file
+     * @return Read status as returned by STEPControl_Reader::ReadFile
+     */
+    IFSelect_ReturnStatus ReadFile(STEPControl_Reader& reader, const std::string& filePath) const;
+};
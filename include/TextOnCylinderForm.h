@@ -25,6 +25,7 @@ class QSlider;
 class QPushButton;
 class QLineEdit;
 class QDoubleSpinBox;
+class BackgroundShapeConverter;
 
 
 /**
@@ -101,28 +102,12 @@ protected:
     TopoDS_Shape engraveTextOntoCylinder(const TopoDS_Shape& cylinder, const TopoDS_Shape& text, double depth);
     
     /**
-     * @brief Convert OCCT TopoDS_Shape to Coin3D SoNode
-     * @param shape The OCCT shape to convert
-     * @return Converted Coin3D node, or nullptr if conversion failed
-     */
-    SoNode* convertShapeToCoin3D(const TopoDS_Shape& shape);
-    
-    /**
-     * @brief Recursively convert OCCT TopoDS_Shape to Coin3D SoNode
-     * @param shape The OCCT shape to convert
-     * @param deviation Deviation for mesh generation
-     * @param angularDeflection Angular deflection for mesh generation
-     * @param color Color to use for the shape material
-     * @return Converted Coin3D node, or nullptr if conversion failed
-     */
-    SoNode* convertShapeRecursive(TopoDS_Shape shape, double deviation, double angularDeflection, SbColor color = SbColor(0.8, 0.8, 0.8));
-    
-    /**
-     * @brief Display shape in the viewer
+     * @brief Display shape in the viewer; the shape is tessellated on a worker thread
+     *        and added to the scene once it is converted
      * @param shape The OCCT shape to display
      * @param clearExisting Whether to clear existing models (default: true)
      * @param color Color to use for the shape (default: gray)
-     * @return true if successful, false otherwise
+     * @return true if the conversion was started, false otherwise
      */
     bool displayShape(const TopoDS_Shape& shape, bool clearExisting = false, SbColor color = SbColor(0.8, 0.8, 0.8));
 
@@ -191,4 +176,5 @@ private:
     TopoDS_Shape m_text;                  // Text shape
     bool m_cylinderCreated;               // Flag indicating if cylinder is created
     bool m_textCreated;                   // Flag indicating if text is created
+    BackgroundShapeConverter* m_converter; // Converts shapes off the GUI thread
 };
\ No newline at end of file
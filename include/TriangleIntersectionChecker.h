@@ -0,0 +1,96 @@
+#pragma once
+
+#include <TopoDS_Shape.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <gp_XYZ.hxx>
+#include <utility>
+#include <vector>
+
+/**
+ * @class TriangleIntersectionChecker
+ * @brief Detects self-intersections of a shape on its triangulation.
+ *
+ * The triangles of every meshed face are gathered into one soup, a bounding-volume
+ * hierarchy (median split along the longest centroid axis) is built over them, and
+ * each triangle queries the tree for overlapping boxes in parallel. Candidate pairs
+ * get an exact edge/triangle piercing test.
+ *
+ * Triangles that share a vertex (neighbours inside a face or across a shared edge)
+ * are never reported, and touching contacts within the tolerance are ignored, so only
+ * proper crossings of the surface count as self-intersections.
+ *
+ * @code
+ *   BRepMesh_IncrementalMesh mesher(shape, 0.1);
+ *   TriangleIntersectionChecker checker;
+ *   checker.Load(shape);
+ *   if (checker.Perform()) { ... checker.GetFacePairs() ... }
+ * @endcode
+ */
+class TriangleIntersectionChecker {
+public:
+    TriangleIntersectionChecker();
+
+    /**
+     * @brief Collects the triangulation of every face of a meshed shape
+     * @param shape Shape whose faces already carry a triangulation (unmeshed faces are skipped)
+     * @return Number of triangles collected
+     */
+    int Load(const TopoDS_Shape& shape);
+
+    /**
+     * @brief Builds the hierarchy and tests all candidate pairs
+     * @return True if at least one pair of triangles intersects
+     */
+    bool Perform();
+
+    /// Offending face pairs as 1-based indices into GetFaces(), first <= second, sorted
+    const std::vector<std::pair<int, int>>& GetFacePairs() const { return m_facePairs; }
+
+    /// Faces of the loaded shape, indexed as in GetFacePairs()
+    const TopTools_IndexedMapOfShape& GetFaces() const { return m_faces; }
+
+    int GetTriangleCount() const { return static_cast<int>(m_triangles.size()); }
+    int GetIntersectingTrianglePairCount() const { return m_intersectingPairCount; }
+
+    /// Returns wall time of the last Perform() in seconds
+    double GetElapsedSeconds() const { return m_elapsedSeconds; }
+
+    /// Set distance below which vertices coincide and contacts count as touching
+    void SetTolerance(double tolerance) { m_tolerance = tolerance; }
+
+    /// Set whether the tree is traversed in parallel
+    void SetParallel(bool parallel) { m_parallel = parallel; }
+
+private:
+    struct Triangle {
+        gp_XYZ nodes[3];
+        int face;
+    };
+
+    struct BvhNode {
+        double boxMin[3];
+        double boxMax[3];
+        int left;       // Child node indices, -1 for leaves
+        int right;
+        int first;      // First entry in m_order for leaves
+        int count;      // Number of triangles for leaves, 0 for inner nodes
+    };
+
+    int BuildNode(int begin, int end);
+    void CollectPairs(int triangle, std::vector<int>& stack, std::vector<std::pair<int, int>>& pairs, int& hits) const;
+    bool Intersect(const Triangle& a, const Triangle& b) const;
+    bool ShareVertex(const Triangle& a, const Triangle& b) const;
+    bool SegmentPiercesTriangle(const gp_XYZ& p0, const gp_XYZ& p1, const Triangle& triangle) const;
+
+    TopTools_IndexedMapOfShape m_faces;
+    std::vector<Triangle> m_triangles;
+    std::vector<double> m_boxes;        // 6 values (min xyz, max xyz) per triangle
+    std::vector<int> m_order;           // Triangle indices in tree order
+    std::vector<BvhNode> m_nodes;
+    std::vector<std::pair<int, int>> m_facePairs;
+
+    double m_tolerance;
+    bool m_parallel;
+    int m_intersectingPairCount;
+    double m_elapsedSeconds;
+};
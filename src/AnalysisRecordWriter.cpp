@@ -0,0 +1,125 @@
+#include "AnalysisRecordWriter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+AnalysisRecordWriter::AnalysisRecordWriter(std::ostream& out)
+    : out_(out)
+    , inRecord_(false)
+    , recordCount_(0)
+{
+}
+
+void AnalysisRecordWriter::beginRecord(const char* recordType)
+{
+    if (inRecord_) {
+        endRecord();
+    }
+
+    out_ << '{';
+    inRecord_ = true;
+
+    // The record type is always the first key so consumers can dispatch on it
+    out_ << "\"record\":";
+    writeString(recordType, std::strlen(recordType));
+}
+
+void AnalysisRecordWriter::field(const char* key, const std::string& value)
+{
+    writeKey(key);
+    writeString(value.data(), value.size());
+}
+
+void AnalysisRecordWriter::field(const char* key, const char* value)
+{
+    writeKey(key);
+    if (value == nullptr) {
+        out_ << "null";
+        return;
+    }
+    writeString(value, std::strlen(value));
+}
+
+void AnalysisRecordWriter::field(const char* key, int value)
+{
+    writeKey(key);
+    out_ << value;
+}
+
+void AnalysisRecordWriter::field(const char* key, long long value)
+{
+    writeKey(key);
+    out_ << value;
+}
+
+void AnalysisRecordWriter::field(const char* key, double value)
+{
+    writeKey(key);
+
+    // JSON has no representation for NaN/Inf
+    if (!std::isfinite(value)) {
+        out_ << "null";
+        return;
+    }
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    out_ << buffer;
+}
+
+void AnalysisRecordWriter::field(const char* key, bool value)
+{
+    writeKey(key);
+    out_ << (value ? "true" : "false");
+}
+
+void AnalysisRecordWriter::endRecord()
+{
+    if (!inRecord_) {
+        return;
+    }
+
+    out_ << "}\n";
+    inRecord_ = false;
+    recordCount_++;
+}
+
+void AnalysisRecordWriter::flush()
+{
+    out_.flush();
+}
+
+void AnalysisRecordWriter::writeKey(const char* key)
+{
+    out_ << ',';
+    writeString(key, std::strlen(key));
+    out_ << ':';
+}
+
+void AnalysisRecordWriter::writeString(const char* value, std::size_t length)
+{
+    out_ << '"';
+    for (std::size_t i = 0; i < length; ++i) {
+        const unsigned char c = static_cast<unsigned char>(value[i]);
+        switch (c) {
+        case '"':  out_ << "\\\""; break;
+        case '\\': out_ << "\\\\"; break;
+        case '\n': out_ << "\\n"; break;
+        case '\r': out_ << "\\r"; break;
+        case '\t': out_ << "\\t"; break;
+        default:
+            if (c < 0x20) {
+                // Remaining control characters; UTF-8 bytes pass through unchanged
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out_ << escaped;
+            }
+            else {
+                out_ << static_cast<char>(c);
+            }
+            break;
+        }
+    }
+    out_ << '"';
+}
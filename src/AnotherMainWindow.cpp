@@ -52,6 +52,7 @@ AnotherMainWindow::AnotherMainWindow(QWidget* parent)
     , m_controlLayout(nullptr)
     , m_infoLabel(nullptr)
     , m_progressBar(nullptr)
+    , m_loadedRootCount(0)
     , m_menuBar(nullptr)
     , m_fileMenu(nullptr)
     , m_viewMenu(nullptr)
@@ -262,9 +263,25 @@ void AnotherMainWindow::openSTEPFile()
         printf("Opening STEP file: %s\n", filePath.toLocal8Bit().constData());
         #endif
 
-        // Load in a separate thread to avoid UI blocking
+        m_loadedRootCount = 0;
+        m_progressBar->setRange(0, 0);
+
+        // Load in a separate thread to avoid UI blocking; every root is posted to the
+        // UI as soon as it is transferred (bounding box) and meshed (shape)
         QThreadPool::globalInstance()->start([this, filePath]() {
-            bool success = m_stepLoader->loadSTEPFile(filePath);
+            STEPLoader::ProgressiveCallbacks callbacks;
+            callbacks.rootTransferred = [this](int rootIndex, int rootCount, const Bnd_Box& box) {
+                QMetaObject::invokeMethod(this, [this, rootIndex, rootCount, box]() {
+                    onRootTransferred(rootIndex, rootCount, box);
+                    }, Qt::QueuedConnection);
+            };
+            callbacks.rootReady = [this](int rootIndex, int rootCount, const TopoDS_Shape& shape) {
+                QMetaObject::invokeMethod(this, [this, rootIndex, rootCount, shape]() {
+                    onRootLoaded(rootIndex, rootCount, shape);
+                    }, Qt::QueuedConnection);
+            };
+
+            bool success = m_stepLoader->loadSTEPFileProgressive(filePath, callbacks);
             QString message = success ? "load success" : "load failed";
             
             #ifdef ENABLE_CONSOLE_OUTPUT
@@ -318,17 +335,37 @@ void AnotherMainWindow::zoomAll()
     }
 }
 
+void AnotherMainWindow::onRootTransferred(int rootIndex, int rootCount, const Bnd_Box& box)
+{
+    m_occWidget->displayPlaceholder(rootIndex, box);
+
+    // Frame the placeholders until the first shape arrives so something is visible right away
+    if (m_loadedRootCount == 0) {
+        m_occWidget->fitAll();
+    }
+    m_infoLabel->setText(QString("loading root %1 / %2...").arg(rootIndex).arg(rootCount));
+}
+
+void AnotherMainWindow::onRootLoaded(int rootIndex, int rootCount, const TopoDS_Shape& shape)
+{
+    m_occWidget->replacePlaceholder(rootIndex, shape);
+    m_loadedRootCount++;
+
+    if (m_loadedRootCount == 1) {
+        m_occWidget->fitAll();
+    }
+    m_progressBar->setRange(0, rootCount);
+    m_progressBar->setValue(rootIndex);
+}
+
 void AnotherMainWindow::onFileLoaded(bool success, const QString& message)
 {
     m_progressBar->setVisible(false);
     m_infoLabel->setText(message);
+    m_occWidget->clearPlaceholders();
 
     if (success) {
-        // LOAD SHAPES INTO OCC WIDGET
-        const auto& shapes = m_stepLoader->getShapes();
-        for (const auto& shape : shapes) {
-            m_occWidget->displayShape(shape);
-        }
+        // Shapes were displayed root by root while loading
         m_occWidget->fitAll();
     }
     else {
@@ -0,0 +1,80 @@
+#include "BackgroundShapeConverter.h"
+
+#include <QMetaObject>
+#include <QObject>
+#include <Inventor/nodes/SoNode.h>
+#include <Standard_Failure.hxx>
+
+BackgroundShapeConverter::BackgroundShapeConverter(QObject* receiver)
+    : m_receiver(receiver)
+    , m_canceled(std::make_shared<std::atomic_bool>(false))
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+BackgroundShapeConverter::~BackgroundShapeConverter()
+{
+    cancel();
+    waitForDone();
+}
+
+void BackgroundShapeConverter::start(const std::vector<TopoDS_Shape>& parts, PartConverter converter, Callbacks callbacks)
+{
+    QObject* receiver = m_receiver;
+    std::shared_ptr<std::atomic_bool> canceled = m_canceled;
+
+    m_pool.start([receiver, parts, converter, callbacks, canceled]() {
+        const int count = static_cast<int>(parts.size());
+        int converted = 0;
+        for (int i = 0; i < count && !*canceled; i++) {
+            SoNode* node = nullptr;
+            try {
+                node = converter(parts[i]);
+            }
+            catch (const Standard_Failure&) {
+                node = nullptr;
+            }
+            if (!node) {
+                continue;
+            }
+
+            // Keep the node alive until the GUI thread has taken it
+            node->ref();
+            converted++;
+            QMetaObject::invokeMethod(receiver, [node, i, count, callbacks, canceled]() {
+                if (!*canceled && callbacks.partReady) {
+                    callbacks.partReady(node, i, count);
+                }
+                node->unref();
+            }, Qt::QueuedConnection);
+        }
+
+        QMetaObject::invokeMethod(receiver, [converted, count, callbacks, canceled]() {
+            if (!*canceled && callbacks.finished) {
+                callbacks.finished(converted, count);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void BackgroundShapeConverter::queue(std::function<void()> task)
+{
+    std::shared_ptr<std::atomic_bool> canceled = m_canceled;
+    m_pool.start([task, canceled]() {
+        if (!*canceled) {
+            task();
+        }
+    });
+}
+
+void BackgroundShapeConverter::cancel()
+{
+    // Running and queued work keeps the old flag; later conversions get a fresh one
+    *m_canceled = true;
+    m_canceled = std::make_shared<std::atomic_bool>(false);
+}
+
+void BackgroundShapeConverter::waitForDone()
+{
+    m_pool.waitForDone();
+}
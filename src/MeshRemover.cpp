@@ -1,4 +1,5 @@
 #include "MeshRemover.h"
+#include "MeshingWatchdog.h"
 
 // OCCT Includes
 #include <TopExp_Explorer.hxx>
@@ -16,11 +17,18 @@
 #include <TopoDS_Shell.hxx>
 #include <TopoDS_Wire.hxx>
 
+#include <algorithm>
+
 MeshRemover::MeshRemover(double deflection, double angle)
     : deflection_(deflection)
     , angle_(angle)
+    , timeLimit_(0.0)
+    , memoryLimit_(0.0)
+    , releaseTriangulation_(false)
     , meshableCount_(0)
     , nonMeshableCount_(0)
+    , timedOutCount_(0)
+    , meshAttemptCount_(0)
 {
     // 初始化复合形状
     BRep_Builder localBuilder;
@@ -42,6 +50,9 @@ bool MeshRemover::removeMeshableParts(const TopoDS_Shape& inputShape, TopoDS_Sha
     // 重置统计信息
     meshableCount_ = 0;
     nonMeshableCount_ = 0;
+    timedOutCount_ = 0;
+    meshAttemptCount_ = 0;
+    memoryCeiling_.Reset();
     
     // 清空之前的结果
     BRep_Builder localBuilder;
@@ -77,6 +88,31 @@ double MeshRemover::getAngle() const
     return angle_;
 }
 
+void MeshRemover::setTimeLimit(double seconds)
+{
+    timeLimit_ = seconds;
+}
+
+void MeshRemover::setMemoryLimit(double megabytes)
+{
+    memoryLimit_ = megabytes;
+}
+
+void MeshRemover::setReleaseTriangulation(bool release)
+{
+    releaseTriangulation_ = release;
+}
+
+void MeshRemover::setMemoryCeiling(double megabytes)
+{
+    memoryCeiling_.SetCeiling(megabytes);
+}
+
+int MeshRemover::getForcedReleaseCount() const
+{
+    return memoryCeiling_.GetForcedReleaseCount();
+}
+
 int MeshRemover::getMeshablePartCount() const
 {
     return meshableCount_;
@@ -87,6 +123,16 @@ int MeshRemover::getNonMeshablePartCount() const
     return nonMeshableCount_;
 }
 
+int MeshRemover::getTimedOutPartCount() const
+{
+    return timedOutCount_;
+}
+
+int MeshRemover::getMeshAttemptCount() const
+{
+    return meshAttemptCount_;
+}
+
 const TopoDS_Compound& MeshRemover::getMeshableParts() const
 {
     return meshableParts_;
@@ -121,11 +167,25 @@ bool MeshRemover::isMeshable(const TopoDS_Shape& shape)
 bool MeshRemover::meshShape(const TopoDS_Shape& shape)
 {
     try {
-        // 创建三角剖分器
-        BRepMesh_IncrementalMesh meshBuilder(shape, deflection_, Standard_False, angle_, Standard_True);
-        meshBuilder.Perform();
+        // 在预算约束下进行三角剖分
+        IMeshTools_Parameters params;
+        params.Deflection = deflection_;
+        params.Angle = angle_;
+        params.Relative = Standard_False;
+        params.InParallel = Standard_True;
         
-        return meshBuilder.IsDone();
+        Handle(MeshingWatchdog) watchdog = new MeshingWatchdog(timeLimit_, memoryLimit_);
+        meshAttemptCount_++;
+        bool isDone = watchdog->Mesh(shape, params);
+        
+        if (watchdog->IsBudgetExceeded()) {
+            // 超出预算：清除部分三角剖分结果，按不可三角剖分处理（复合形状会继续分解）
+            BRepTools::Clean(shape);
+            timedOutCount_++;
+            return false;
+        }
+        
+        return isDone;
     } catch (...) {
         return false;
     }
@@ -171,6 +231,7 @@ void MeshRemover::processShapeRecursive(const TopoDS_Shape& shape, TopoDS_Compou
         BRep_Builder localBuilder;
         localBuilder.Add(meshableParts_, shape);
         meshableCount_++;
+        releaseTriangulation(shape);
         return;
     }
     
@@ -228,6 +289,7 @@ void MeshRemover::processShapeRecursive(const TopoDS_Shape& shape, TopoDS_Compou
         BRep_Builder localBuilder;
         localBuilder.Add(nonMeshableParts, shape);
         nonMeshableCount_++;
+        releaseTriangulation(shape);
         break;
     }
     case TopAbs_WIRE:
@@ -251,6 +313,18 @@ void MeshRemover::processShapeRecursive(const TopoDS_Shape& shape, TopoDS_Compou
     }
 }
 
+void MeshRemover::releaseTriangulation(const TopoDS_Shape& shape)
+{
+    if (releaseTriangulation_) {
+        // 只需要分类结果，探测生成的三角剖分立即释放
+        BRepTools::Clean(shape);
+        return;
+    }
+    
+    // 超过内存上限时释放上次释放以来分类的形状的三角剖分
+    memoryCeiling_.Add(shape);
+}
+
 void MeshRemover::removeMeshableFromCompound(const TopoDS_Compound& inputCompound, TopoDS_Compound& outputCompound)
 {
     // 遍历复合形状中的所有子形状
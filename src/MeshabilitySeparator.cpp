@@ -1,7 +1,11 @@
 ﻿#include "MeshabilitySeparator.h"
+#include "AnalysisRecordWriter.h"
+#include "MeshingWatchdog.h"
 
 // OCCT includes for meshing and geometry
 #include <BRepMesh_IncrementalMesh.hxx>
+#include <IMeshTools_Parameters.hxx>
+#include <BRepTools.hxx>
 #include <BRep_Tool.hxx>
 #include <Poly_Triangulation.hxx>
 
@@ -89,7 +93,16 @@ angle_(angle),
 relative_(relative),
 parallel_(parallel&& OSD_Parallel::NbLogicalProcessors() > 1),
 tryFixBeforeMeshing_(true),
-useCache_(true)
+useCache_(true),
+computeEdgeMetrics_(true),
+keepShapeInfo_(true),
+verbose_(true),
+timeLimitSeconds_(0.0),
+memoryLimitMB_(0.0),
+incrementalAnalysis_(false),
+recordWriter_(nullptr),
+meshableCount_(0),
+nonMeshableCount_(0)
 {
     // Initialize statistics
     ResetStatistics();
@@ -110,7 +123,16 @@ bool MeshabilitySeparator::Separate(
     // Clear previous results
     meshableInfo_.clear();
     nonMeshableInfo_.clear();
-    ClearCache();
+    meshableCount_ = 0;
+    nonMeshableCount_ = 0;
+    if (incrementalAnalysis_) {
+        // Result caches depend on the tolerance; edge metrics and face history do not
+        meshableCache_.Clear();
+        failureCache_.Clear();
+    }
+    else {
+        ClearCache();
+    }
     ResetStatistics();
 
     // Reinitialize output compounds
@@ -124,8 +146,10 @@ bool MeshabilitySeparator::Separate(
         return false;
     }
 
-    std::cout << "Starting meshability separation..." << std::endl;
-    std::cout << "Input shape type: " << ShapeTypeToString(inputShape.ShapeType()) << std::endl;
+    if (verbose_) {
+        std::cout << "Starting meshability separation..." << std::endl;
+        std::cout << "Input shape type: " << ShapeTypeToString(inputShape.ShapeType()) << std::endl;
+    }
 
     // Start recursive processing
     bool processingSuccess = ProcessShape(inputShape, true);
@@ -134,9 +158,15 @@ bool MeshabilitySeparator::Separate(
     meshableParts = meshableParts_;
     nonMeshableParts = nonMeshableParts_;
 
-    std::cout << "Separation completed!" << std::endl;
-    std::cout << "Meshable parts: " << meshableInfo_.size() << " elements" << std::endl;
-    std::cout << "Non-meshable parts: " << nonMeshableInfo_.size() << " elements" << std::endl;
+    if (recordWriter_ != nullptr) {
+        WriteSummaryRecord(processingSuccess);
+    }
+
+    if (verbose_) {
+        std::cout << "Separation completed!" << std::endl;
+        std::cout << "Meshable parts: " << meshableCount_ << " elements" << std::endl;
+        std::cout << "Non-meshable parts: " << nonMeshableCount_ << " elements" << std::endl;
+    }
 
     return processingSuccess;
 }
@@ -152,27 +182,21 @@ bool MeshabilitySeparator::ProcessShape(const TopoDS_Shape& shape, bool topLevel
     bool cachedIsMeshable = false;
     MeshFailureReason cachedReason = SUCCESS;
     if (useCache_ && IsShapeInCache(shape, cachedIsMeshable, cachedReason)) {
-        // Found in cache - use cached result
+        // Found in cache - use cached result (edge metrics come from the per-edge memo)
         ShapeAnalysisInfo info = AnalyzeShape(shape);
         info.failureReason = cachedReason;
 
-        BRep_Builder builder;
-        if (cachedIsMeshable) {
-            builder.Add(meshableParts_, shape);
-            meshableInfo_.push_back(info);
-        }
-        else {
-            builder.Add(nonMeshableParts_, shape);
-            nonMeshableInfo_.push_back(info);
-        }
+        StoreResult(info, cachedIsMeshable);
 
         UpdateStatistics(cachedReason, shape.ShapeType());
         return cachedIsMeshable;
     }
 
-    // Not in cache - process based on shape type
+    // Not in cache - process based on shape type.
+    // Faces and edges are analyzed by ProcessFace/ProcessEdge, other types carry no metrics.
     TopAbs_ShapeEnum shapeType = shape.ShapeType();
-    ShapeAnalysisInfo info = AnalyzeShape(shape);
+    ShapeAnalysisInfo info;
+    info.shape = shape;
     bool isMeshable = false;
 
     switch (shapeType) {
@@ -186,7 +210,7 @@ bool MeshabilitySeparator::ProcessShape(const TopoDS_Shape& shape, bool topLevel
 
     case TopAbs_SOLID:
         // Try to mesh the solid as a whole
-        if (TryMeshing(shape, info)) {
+        if (MeshOrPredict(shape, info)) {
             isMeshable = true;
         }
         else {
@@ -198,7 +222,7 @@ bool MeshabilitySeparator::ProcessShape(const TopoDS_Shape& shape, bool topLevel
 
     case TopAbs_SHELL:
         // Try to mesh the shell as a whole
-        if (TryMeshing(shape, info)) {
+        if (MeshOrPredict(shape, info)) {
             isMeshable = true;
         }
         else {
@@ -238,17 +262,13 @@ bool MeshabilitySeparator::ProcessShape(const TopoDS_Shape& shape, bool topLevel
 
     // For shapes that weren't processed by decomposition methods
     if (shapeType != TopAbs_FACE && shapeType != TopAbs_EDGE && shapeType != TopAbs_VERTEX) {
-        BRep_Builder builder;
-
         if (isMeshable && shapeType != TopAbs_COMPOUND && shapeType != TopAbs_COMPSOLID) {
             // Add meshable solids/shells to output
-            builder.Add(meshableParts_, shape);
-            meshableInfo_.push_back(info);
+            StoreResult(info, true);
         }
         else if (!isMeshable && (shapeType == TopAbs_SOLID || shapeType == TopAbs_SHELL)) {
             // Add failed solids/shells to non-meshable output
-            builder.Add(nonMeshableParts_, shape);
-            nonMeshableInfo_.push_back(info);
+            StoreResult(info, false);
         }
         // Compounds are not added to output - only their components are
 
@@ -264,7 +284,8 @@ bool MeshabilitySeparator::ProcessShape(const TopoDS_Shape& shape, bool topLevel
 
 // ========== Meshing Attempt Method ==========
 
-bool MeshabilitySeparator::TryMeshing(const TopoDS_Shape& shape, ShapeAnalysisInfo& info) {
+bool MeshabilitySeparator::TryMeshing(const TopoDS_Shape& shape, ShapeAnalysisInfo& info,
+                                      Handle(ShapeBuild_ReShape)* fixContext) {
     if (shape.IsNull()) {
         info.failureReason = NULL_GEOMETRY;
         info.reasonDescription = "Shape is null";
@@ -274,15 +295,30 @@ bool MeshabilitySeparator::TryMeshing(const TopoDS_Shape& shape, ShapeAnalysisIn
     // Optional geometry repair
     TopoDS_Shape shapeToMesh = shape;
     if (tryFixBeforeMeshing_) {
-        shapeToMesh = TryFixShape(shape);
+        shapeToMesh = TryFixShape(shape, fixContext);
     }
 
     try {
-        // Attempt meshing
-        BRepMesh_IncrementalMesh mesher(shapeToMesh, deflection_, angle_, relative_, parallel_);
-        mesher.Perform();
+        // Attempt meshing under the per-shape budget
+        IMeshTools_Parameters params;
+        params.Deflection = deflection_;
+        params.Angle = angle_;
+        params.Relative = relative_;
+        params.InParallel = parallel_;
+
+        Handle(MeshingWatchdog) watchdog = new MeshingWatchdog(timeLimitSeconds_, memoryLimitMB_);
+        stats_.meshAttempts++;
+        bool isDone = watchdog->Mesh(shapeToMesh, params);
+
+        if (watchdog->IsBudgetExceeded()) {
+            // Drop the partial triangulation left by the cancelled attempt
+            BRepTools::Clean(shapeToMesh);
+            info.failureReason = TIMEOUT;
+            info.reasonDescription = watchdog->GetStatusDescription();
+            return false;
+        }
 
-        if (!mesher.IsDone()) {
+        if (!isDone) {
             info.failureReason = MESHING_FAILED;
             info.reasonDescription = "Meshing algorithm failed to complete";
             return false;
@@ -332,6 +368,39 @@ bool MeshabilitySeparator::TryMeshing(const TopoDS_Shape& shape, ShapeAnalysisIn
     }
 }
 
+bool MeshabilitySeparator::MeshOrPredict(const TopoDS_Shape& shape, ShapeAnalysisInfo& info) {
+    if (!incrementalAnalysis_) {
+        return TryMeshing(shape, info);
+    }
+
+    int triangleCount = 0;
+    switch (PredictFromHistory(shape, triangleCount)) {
+    case PREDICT_MESHABLE:
+        info.failureReason = SUCCESS;
+        info.triangleCount = triangleCount;
+        stats_.reusedOutcomes++;
+        return true;
+
+    case PREDICT_NON_MESHABLE:
+        // A known-bad face would fail the whole shape - go straight to decomposition
+        info.failureReason = MESHING_FAILED;
+        info.reasonDescription = "Contains faces that failed in a previous analysis";
+        stats_.reusedOutcomes++;
+        return false;
+
+    default:
+        break;
+    }
+
+    Handle(ShapeBuild_ReShape) fixContext;
+    if (!TryMeshing(shape, info, &fixContext)) {
+        return false;
+    }
+
+    RecordMeshedFaces(shape, fixContext);
+    return true;
+}
+
 // ========== Decomposition Methods Implementation ==========
 
 void MeshabilitySeparator::DecomposeCompound(const TopoDS_Shape& compound) {
@@ -375,31 +444,49 @@ void MeshabilitySeparator::DecomposeShell(const TopoDS_Shell& shell) {
 void MeshabilitySeparator::ProcessFace(const TopoDS_Face& face) {
     ShapeAnalysisInfo info = AnalyzeShape(face);
 
+    // Reuse the previous run's outcome when the new parameters cannot change it
+    bool reusedMeshable = false;
+    MeshFailureReason reusedReason = SUCCESS;
+    int reusedTriangles = 0;
+    if (incrementalAnalysis_ && ReuseFaceOutcome(face, reusedMeshable, reusedReason, reusedTriangles)) {
+        info.failureReason = reusedReason;
+        info.triangleCount = reusedTriangles;
+        info.faceCount = 1;
+        if (!reusedMeshable) {
+            info.reasonDescription = "Reused from previous analysis";
+        }
+        stats_.reusedOutcomes++;
+
+        StoreResult(info, reusedMeshable);
+        if (useCache_) {
+            AddToCache(face, reusedMeshable, info.failureReason);
+        }
+        UpdateStatistics(info.failureReason, TopAbs_FACE);
+        return;
+    }
+
     // Validate face topology and geometry
     if (!CheckFaceValidity(face, info)) {
         info.failureReason = DEGENERATE_FACE;
-        BRep_Builder builder;
-        builder.Add(nonMeshableParts_, face);
-        nonMeshableInfo_.push_back(info);
+        StoreResult(info, false);
         UpdateStatistics(info.failureReason, TopAbs_FACE);
 
         if (useCache_) {
             AddToCache(face, false, info.failureReason);
         }
+        if (incrementalAnalysis_) {
+            RecordFaceOutcome(face, false, info.failureReason, 0);
+        }
         return;
     }
 
     // Attempt to mesh this face
     bool isMeshable = TryMeshing(face, info);
 
-    BRep_Builder builder;
-    if (isMeshable) {
-        builder.Add(meshableParts_, face);
-        meshableInfo_.push_back(info);
-    }
-    else {
-        builder.Add(nonMeshableParts_, face);
-        nonMeshableInfo_.push_back(info);
+    StoreResult(info, isMeshable);
+
+    if (incrementalAnalysis_) {
+        RecordFaceOutcome(face, isMeshable, info.failureReason, info.triangleCount);
     }
 
     if (useCache_) {
@@ -415,9 +502,7 @@ void MeshabilitySeparator::ProcessEdge(const TopoDS_Shape& edge) {
     info.failureReason = UNSUPPORTED_SURFACE;
     info.reasonDescription = "Edge cannot be exported to STL format";
 
-    BRep_Builder builder;
-    builder.Add(nonMeshableParts_, edge);
-    nonMeshableInfo_.push_back(info);
+    StoreResult(info, false);
 
     UpdateStatistics(info.failureReason, edge.ShapeType());
 }
@@ -428,9 +513,7 @@ void MeshabilitySeparator::ProcessVertex(const TopoDS_Shape& vertex) {
     info.failureReason = UNSUPPORTED_SURFACE;
     info.reasonDescription = "Vertex cannot be exported to STL format";
 
-    BRep_Builder builder;
-    builder.Add(nonMeshableParts_, vertex);
-    nonMeshableInfo_.push_back(info);
+    StoreResult(info, false);
 
     UpdateStatistics(info.failureReason, vertex.ShapeType());
 }
@@ -470,7 +553,11 @@ ShapeAnalysisInfo MeshabilitySeparator::AnalyzeShape(const TopoDS_Shape& shape)
             }
         }
 
-        // Analyze edge lengths
+        // Analyze edge lengths (skipped entirely for throughput runs)
+        if (!computeEdgeMetrics_) {
+            break;
+        }
+
         info.minEdgeLength = 1e10; // Large initial value
         info.maxEdgeLength = 0.0;
 
@@ -482,7 +569,9 @@ ShapeAnalysisInfo MeshabilitySeparator::AnalyzeShape(const TopoDS_Shape& shape)
     }
 
     case TopAbs_EDGE: {
-        CheckEdgeValidity(shape, info);
+        if (computeEdgeMetrics_) {
+            CheckEdgeValidity(shape, info);
+        }
         break;
     }
 
@@ -558,57 +647,85 @@ bool MeshabilitySeparator::CheckEdgeValidity(const TopoDS_Shape& edge, ShapeAnal
         return false;
     }
 
-    Standard_Real first, last;
-    Handle(Geom_Curve) curve = BRep_Tool::Curve(theEdge, first, last);
+    const EdgeMetrics& metrics = GetEdgeMetrics(theEdge);
 
-    if (curve.IsNull()) {
-        info.failureReason = NULL_GEOMETRY;
-        info.reasonDescription = "Edge has no geometric curve";
+    if (metrics.failureReason != SUCCESS) {
+        info.failureReason = metrics.failureReason;
+        info.reasonDescription = metrics.reasonDescription;
         return false;
     }
 
-    try {
-        // Calculate edge length
-        GeomAdaptor_Curve adaptor(curve, first, last);
-        double length = GCPnts_AbscissaPoint::Length(adaptor);
-
-        // Check for degenerate (extremely short) edges
-        if (length < Precision::Confusion()) {
-            info.failureReason = DEGENERATE_EDGE;
-            info.reasonDescription = "Edge length is below precision threshold";
-            return false;
-        }
+    // Update min/max edge length statistics
+    if (metrics.length < info.minEdgeLength) {
+        info.minEdgeLength = metrics.length;
+    }
+    if (metrics.length > info.maxEdgeLength) {
+        info.maxEdgeLength = metrics.length;
+    }
 
-        // Update min/max edge length statistics
-        if (length < info.minEdgeLength) {
-            info.minEdgeLength = length;
-        }
-        if (length > info.maxEdgeLength) {
-            info.maxEdgeLength = length;
-        }
+    if (metrics.isComplexCurve) {
+        info.hasComplexCurves = true;
+    }
 
-        // Check curve type
-        GeomAbs_CurveType curveType = adaptor.GetType();
-        if (curveType == GeomAbs_BSplineCurve ||
-            curveType == GeomAbs_BezierCurve ||
-            curveType == GeomAbs_OffsetCurve ||
-            curveType == GeomAbs_OtherCurve) {
-            info.hasComplexCurves = true;
-        }
+    return true;
+}
 
+const MeshabilitySeparator::EdgeMetrics& MeshabilitySeparator::GetEdgeMetrics(const TopoDS_Edge& edge) {
+    // Edges are shared between faces (and between a shape and its sub-shapes),
+    // so the curve-length integration is done once per unique edge.
+    if (const EdgeMetrics* cached = edgeMetricsCache_.Seek(edge)) {
+        return *cached;
     }
-    catch (...) {
-        info.failureReason = DEGENERATE_EDGE;
-        info.reasonDescription = "Edge length calculation failed";
-        return false;
+
+    EdgeMetrics metrics;
+    metrics.length = 0.0;
+    metrics.failureReason = SUCCESS;
+    metrics.reasonDescription = nullptr;
+    metrics.isComplexCurve = false;
+
+    Standard_Real first, last;
+    Handle(Geom_Curve) curve = BRep_Tool::Curve(edge, first, last);
+
+    if (curve.IsNull()) {
+        metrics.failureReason = NULL_GEOMETRY;
+        metrics.reasonDescription = "Edge has no geometric curve";
+    }
+    else {
+        try {
+            // Calculate edge length
+            GeomAdaptor_Curve adaptor(curve, first, last);
+            metrics.length = GCPnts_AbscissaPoint::Length(adaptor);
+
+            // Check for degenerate (extremely short) edges
+            if (metrics.length < Precision::Confusion()) {
+                metrics.failureReason = DEGENERATE_EDGE;
+                metrics.reasonDescription = "Edge length is below precision threshold";
+            }
+            else {
+                // Check curve type
+                GeomAbs_CurveType curveType = adaptor.GetType();
+                metrics.isComplexCurve = (curveType == GeomAbs_BSplineCurve ||
+                    curveType == GeomAbs_BezierCurve ||
+                    curveType == GeomAbs_OffsetCurve ||
+                    curveType == GeomAbs_OtherCurve);
+            }
+        }
+        catch (...) {
+            metrics.failureReason = DEGENERATE_EDGE;
+            metrics.reasonDescription = "Edge length calculation failed";
+        }
     }
 
-    return true;
+    return *edgeMetricsCache_.Bound(edge, metrics);
 }
 
 // ========== Geometry Repair Methods ==========
 
-TopoDS_Shape MeshabilitySeparator::TryFixShape(const TopoDS_Shape& shape) {
+TopoDS_Shape MeshabilitySeparator::TryFixShape(const TopoDS_Shape& shape, Handle(ShapeBuild_ReShape)* context) {
+    if (context != nullptr) {
+        context->Nullify();
+    }
+
     try {
         Handle(ShapeFix_Shape) fixer = new ShapeFix_Shape(shape);
         fixer->SetPrecision(1e-6);
@@ -616,6 +733,9 @@ TopoDS_Shape MeshabilitySeparator::TryFixShape(const TopoDS_Shape& shape) {
         fixer->Perform();
 
         if (fixer->Status(ShapeExtend_DONE)) {
+            if (context != nullptr) {
+                *context = fixer->Context();
+            }
             return fixer->Shape();
         }
     }
@@ -685,6 +805,183 @@ void MeshabilitySeparator::AddToCache(const TopoDS_Shape& shape, bool isMeshable
 void MeshabilitySeparator::ClearCache() {
     meshableCache_.Clear();
     failureCache_.Clear();
+    edgeMetricsCache_.Clear();
+}
+
+// ========== Incremental Re-analysis ==========
+
+bool MeshabilitySeparator::ReuseFaceOutcome(const TopoDS_Face& face, bool& meshable,
+    MeshFailureReason& reason, int& triangleCount) const {
+    const FaceOutcome* previous = faceHistory_.Seek(face);
+    if (previous == nullptr || previous->relative != relative_) {
+        return false;
+    }
+
+    const bool finerOrEqual = previous->deflection <= deflection_ && previous->angle <= angle_;
+    const bool coarserOrEqual = previous->deflection >= deflection_ && previous->angle >= angle_;
+
+    meshable = previous->meshable;
+    reason = previous->reason;
+    triangleCount = previous->triangleCount;
+
+    if (previous->meshable) {
+        // A mesh at a finer tolerance also satisfies a coarser one;
+        // a coarser mesh has to be refined
+        return finerOrEqual;
+    }
+
+    switch (previous->reason) {
+    case DEGENERATE_FACE:
+    case NULL_GEOMETRY:
+        // Validation failures do not depend on the meshing tolerance
+        return true;
+    case TIMEOUT:
+        // Budget dependent - always retry
+        return false;
+    default:
+        // Failed at a coarser-or-equal tolerance: a finer one is not expected to succeed.
+        // Failed at a finer tolerance: retry at the coarser one.
+        return coarserOrEqual;
+    }
+}
+
+MeshabilitySeparator::HistoryPrediction MeshabilitySeparator::PredictFromHistory(
+    const TopoDS_Shape& shape, int& triangleCount) const {
+    bool allMeshable = true;
+    triangleCount = 0;
+
+    for (TopExp_Explorer faceExp(shape, TopAbs_FACE); faceExp.More(); faceExp.Next()) {
+        bool meshable = false;
+        MeshFailureReason reason = SUCCESS;
+        int faceTriangles = 0;
+
+        if (!ReuseFaceOutcome(TopoDS::Face(faceExp.Current()), meshable, reason, faceTriangles)) {
+            // Keep scanning - a known-bad face still decides the outcome
+            allMeshable = false;
+            continue;
+        }
+
+        if (!meshable) {
+            return PREDICT_NON_MESHABLE;
+        }
+        triangleCount += faceTriangles;
+    }
+
+    return allMeshable ? PREDICT_MESHABLE : PREDICT_UNKNOWN;
+}
+
+void MeshabilitySeparator::RecordFaceOutcome(const TopoDS_Face& face, bool meshable,
+    MeshFailureReason reason, int triangleCount) {
+    FaceOutcome outcome;
+    outcome.deflection = deflection_;
+    outcome.angle = angle_;
+    outcome.relative = relative_;
+    outcome.meshable = meshable;
+    outcome.reason = reason;
+    outcome.triangleCount = triangleCount;
+    faceHistory_.Bind(face, outcome);
+}
+
+void MeshabilitySeparator::RecordMeshedFaces(const TopoDS_Shape& shape, const Handle(ShapeBuild_ReShape)& fixContext) {
+    for (TopExp_Explorer faceExp(shape, TopAbs_FACE); faceExp.More(); faceExp.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(faceExp.Current());
+
+        // A repaired face may have been replaced, split into several faces or removed;
+        // the triangles are those of whatever replaced it in the meshed shape
+        TopoDS_Shape meshedFace = fixContext.IsNull() ? TopoDS_Shape(face) : fixContext->Value(face);
+        int triangleCount = 0;
+        if (!meshedFace.IsNull()) {
+            for (TopExp_Explorer meshedExp(meshedFace, TopAbs_FACE); meshedExp.More(); meshedExp.Next()) {
+                TopLoc_Location loc;
+                Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(TopoDS::Face(meshedExp.Current()), loc);
+                if (!triangulation.IsNull()) {
+                    triangleCount += triangulation->NbTriangles();
+                }
+            }
+        }
+        RecordFaceOutcome(face, true, SUCCESS, triangleCount);
+    }
+}
+
+void MeshabilitySeparator::ClearHistory() {
+    faceHistory_.Clear();
+}
+
+// ========== Result Output ==========
+
+void MeshabilitySeparator::StoreResult(const ShapeAnalysisInfo& info, bool isMeshable) {
+    BRep_Builder builder;
+    if (isMeshable) {
+        builder.Add(meshableParts_, info.shape);
+        meshableCount_++;
+        stats_.meshedTriangles += info.triangleCount;
+    }
+    else {
+        builder.Add(nonMeshableParts_, info.shape);
+        nonMeshableCount_++;
+    }
+
+    // Stream the result as soon as the shape is classified
+    if (recordWriter_ != nullptr) {
+        WriteShapeRecord(info, isMeshable);
+    }
+
+    if (keepShapeInfo_) {
+        if (isMeshable) {
+            meshableInfo_.push_back(info);
+        }
+        else {
+            nonMeshableInfo_.push_back(info);
+        }
+    }
+}
+
+void MeshabilitySeparator::WriteShapeRecord(const ShapeAnalysisInfo& info, bool isMeshable) {
+    AnalysisRecordWriter& writer = *recordWriter_;
+    writer.beginRecord("shape");
+    writer.field("analyzer", "MeshabilitySeparator");
+    writer.field("index", meshableCount_ + nonMeshableCount_);
+    writer.field("shapeType", ShapeTypeToString(info.shape.ShapeType()));
+    writer.field("meshable", isMeshable);
+    writer.field("reason", FailureReasonToString(info.failureReason));
+    writer.field("reasonCode", static_cast<int>(info.failureReason));
+    if (!info.reasonDescription.empty()) {
+        writer.field("description", info.reasonDescription);
+    }
+    writer.field("faces", info.faceCount);
+    writer.field("triangles", info.triangleCount);
+    if (computeEdgeMetrics_ && info.maxEdgeLength > 0.0) {
+        writer.field("minEdgeLength", info.minEdgeLength);
+        writer.field("maxEdgeLength", info.maxEdgeLength);
+    }
+    writer.field("complexCurves", info.hasComplexCurves);
+    writer.endRecord();
+}
+
+void MeshabilitySeparator::WriteSummaryRecord(bool processingSuccess) {
+    AnalysisRecordWriter& writer = *recordWriter_;
+    writer.beginRecord("summary");
+    writer.field("analyzer", "MeshabilitySeparator");
+    writer.field("success", processingSuccess);
+    writer.field("deflection", deflection_);
+    writer.field("angle", angle_);
+    writer.field("meshableParts", meshableCount_);
+    writer.field("nonMeshableParts", nonMeshableCount_);
+    writer.field("totalShapes", stats_.totalShapes);
+    writer.field("meshableShapes", stats_.meshableShapes);
+    writer.field("nonMeshableShapes", stats_.nonMeshableShapes);
+    writer.field("facesProcessed", stats_.facesProcessed);
+    writer.field("solidsProcessed", stats_.solidsProcessed);
+    writer.field("shellsProcessed", stats_.shellsProcessed);
+    writer.field("reusedOutcomes", stats_.reusedOutcomes);
+    writer.field("meshAttempts", stats_.meshAttempts);
+    writer.field("meshedTriangles", stats_.meshedTriangles);
+    for (const auto& pair : stats_.failureCounts) {
+        const std::string key = "failures." + FailureReasonToString(pair.first);
+        writer.field(key.c_str(), pair.second);
+    }
+    writer.endRecord();
+    writer.flush();
 }
 
 // ========== Statistics Management ==========
@@ -723,6 +1020,9 @@ void MeshabilitySeparator::ResetStatistics() {
     stats_.facesProcessed = 0;
     stats_.solidsProcessed = 0;
     stats_.shellsProcessed = 0;
+    stats_.reusedOutcomes = 0;
+    stats_.meshAttempts = 0;
+    stats_.meshedTriangles = 0;
     stats_.failureCounts.clear();
 }
 
@@ -743,7 +1043,15 @@ std::string MeshabilitySeparator::GenerateReport() const {
     report << "  - Deflection: " << deflection_ << "\n";
     report << "  - Angle: " << angle_ << " radians\n";
     report << "  - Geometry Repair: " << (tryFixBeforeMeshing_ ? "Enabled" : "Disabled") << "\n";
-    report << "  - Caching: " << (useCache_ ? "Enabled" : "Disabled") << "\n\n";
+    report << "  - Caching: " << (useCache_ ? "Enabled" : "Disabled") << "\n";
+    report << "  - Edge Metrics: " << (computeEdgeMetrics_ ? "Enabled" : "Disabled") << "\n";
+    if (timeLimitSeconds_ > 0.0) {
+        report << "  - Time Budget: " << timeLimitSeconds_ << " s per shape\n";
+    }
+    if (memoryLimitMB_ > 0.0) {
+        report << "  - Memory Budget: " << memoryLimitMB_ << " MiB per shape\n";
+    }
+    report << "\n";
 
     report << "Statistics:\n";
     report << "  - Total Shapes: " << stats_.totalShapes << "\n";
@@ -758,7 +1066,11 @@ std::string MeshabilitySeparator::GenerateReport() const {
     report << "\nProcessing Details:\n";
     report << "  - Faces Processed: " << stats_.facesProcessed << "\n";
     report << "  - Solids Processed: " << stats_.solidsProcessed << "\n";
-    report << "  - Shells Processed: " << stats_.shellsProcessed << "\n\n";
+    report << "  - Shells Processed: " << stats_.shellsProcessed << "\n";
+    if (incrementalAnalysis_) {
+        report << "  - Reused From Previous Run: " << stats_.reusedOutcomes << "\n";
+    }
+    report << "\n";
 
     if (!stats_.failureCounts.empty()) {
         report << "Failure Analysis:\n";
@@ -814,6 +1126,7 @@ std::string MeshabilitySeparator::FailureReasonToString(MeshFailureReason reason
     case NON_MANIFOLD: return "Non-Manifold";
     case COMPLEX_CURVE: return "Complex Curve";
     case UNSUPPORTED_SURFACE: return "Unsupported Surface";
+    case TIMEOUT: return "Timeout";
     case OTHER_REASON: return "Other Reason";
     default: return "Unknown";
     }
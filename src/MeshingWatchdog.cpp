@@ -0,0 +1,162 @@
+#include "MeshingWatchdog.h"
+
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepTools.hxx>
+#include <OSD_MemInfo.hxx>
+#include <Standard_Failure.hxx>
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+    // Minimum interval between two memory samples
+    const long long MEMORY_CHECK_INTERVAL_MS = 50;
+
+    // A memory ceiling samples after this many shapes or this interval, whichever comes first
+    const int CEILING_SAMPLE_SHAPES = 16;
+    const long long CEILING_SAMPLE_INTERVAL_MS = 200;
+
+    // Growth over the level after a release, as a fraction of the ceiling, that forces the next one
+    const double CEILING_HEADROOM = 0.1;
+}
+
+MeshingWatchdog::MeshingWatchdog(double timeLimitSeconds, double memoryLimitMB)
+    : timeLimitSeconds_(timeLimitSeconds)
+    , memoryLimitMB_(memoryLimitMB)
+    , baselineMemoryMB_(0.0)
+    , start_(std::chrono::steady_clock::now())
+    , status_(WITHIN_BUDGET)
+    , lastMemoryCheckMs_(0)
+{
+    if (memoryLimitMB_ > 0.0) {
+        baselineMemoryMB_ = CurrentMemoryMB();
+    }
+}
+
+bool MeshingWatchdog::Mesh(const TopoDS_Shape& shape, const IMeshTools_Parameters& params)
+{
+    if (!IsEnabled()) {
+        BRepMesh_IncrementalMesh mesher(shape, params);
+        return mesher.IsDone();
+    }
+
+    // The watchdog must be held by a Handle while BRepMesh reports to it
+    BRepMesh_IncrementalMesh mesher(shape, params, Start());
+    return mesher.IsDone() && !IsBudgetExceeded();
+}
+
+Standard_Boolean MeshingWatchdog::UserBreak()
+{
+    if (status_.load() != WITHIN_BUDGET) {
+        return Standard_True;
+    }
+
+    const long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+
+    if (timeLimitSeconds_ > 0.0 && elapsedMs > static_cast<long long>(timeLimitSeconds_ * 1000.0)) {
+        status_.store(TIME_EXCEEDED);
+        return Standard_True;
+    }
+
+    if (memoryLimitMB_ > 0.0 && elapsedMs - lastMemoryCheckMs_.load() >= MEMORY_CHECK_INTERVAL_MS) {
+        std::unique_lock<std::mutex> lock(memoryMutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            lastMemoryCheckMs_.store(elapsedMs);
+            if (CurrentMemoryMB() - baselineMemoryMB_ > memoryLimitMB_) {
+                status_.store(MEMORY_EXCEEDED);
+                return Standard_True;
+            }
+        }
+    }
+
+    return Standard_False;
+}
+
+void MeshingWatchdog::Show(const Message_ProgressScope& /*theScope*/, const Standard_Boolean /*isForce*/)
+{
+}
+
+std::string MeshingWatchdog::GetStatusDescription() const
+{
+    std::ostringstream ss;
+    switch (GetStatus()) {
+    case TIME_EXCEEDED:
+        ss << "Meshing exceeded time budget of " << timeLimitSeconds_ << " s";
+        break;
+    case MEMORY_EXCEEDED:
+        ss << "Meshing exceeded memory budget of " << memoryLimitMB_ << " MiB";
+        break;
+    default:
+        ss << "Meshing within budget";
+        break;
+    }
+    return ss.str();
+}
+
+double MeshingWatchdog::GetElapsedSeconds() const
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    return elapsed.count();
+}
+
+double MeshingWatchdog::CurrentMemoryMB()
+{
+    try {
+        OSD_MemInfo memInfo(Standard_False);
+        memInfo.Update();
+        return memInfo.ValuePreciseMiB(OSD_MemInfo::MemWorkingSet);
+    }
+    catch (Standard_Failure const&) {
+        return 0.0;
+    }
+}
+
+MemoryCeiling::MemoryCeiling()
+    : ceilingMB_(0.0)
+    , thresholdMB_(0.0)
+    , forcedReleaseCount_(0)
+    , addedSinceSample_(-1)
+{
+}
+
+void MemoryCeiling::SetCeiling(double megabytes)
+{
+    ceilingMB_ = megabytes;
+    thresholdMB_ = megabytes;
+}
+
+void MemoryCeiling::Reset()
+{
+    thresholdMB_ = ceilingMB_;
+    forcedReleaseCount_ = 0;
+    addedSinceSample_ = -1;
+    pending_.clear();
+}
+
+void MemoryCeiling::Add(const TopoDS_Shape& shape)
+{
+    if (ceilingMB_ <= 0.0) {
+        return;
+    }
+
+    // Shapes collected before the last release are already clean
+    pending_.push_back(shape);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (addedSinceSample_ >= 0 && ++addedSinceSample_ < CEILING_SAMPLE_SHAPES
+        && std::chrono::duration_cast<std::chrono::milliseconds>(now - lastSample_).count() < CEILING_SAMPLE_INTERVAL_MS) {
+        return;
+    }
+    addedSinceSample_ = 0;
+    lastSample_ = now;
+
+    if (MeshingWatchdog::CurrentMemoryMB() > thresholdMB_) {
+        for (const TopoDS_Shape& collected : pending_) {
+            BRepTools::Clean(collected);
+        }
+        pending_.clear();
+        forcedReleaseCount_++;
+
+        thresholdMB_ = std::max(ceilingMB_, MeshingWatchdog::CurrentMemoryMB() + ceilingMB_ * CEILING_HEADROOM);
+    }
+}
@@ -6,6 +6,10 @@
 #include <Aspect_DisplayConnection.hxx>
 #include <V3d_Viewer.hxx>
 #include <AIS_InteractiveContext.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <Precision.hxx>
+#include <algorithm>
 
 #include <QMouseEvent>
 #include <QPaintEvent>
@@ -168,12 +172,80 @@ void OccWidget::fitAll()
 
 void OccWidget::eraseAll()
 {
+    m_placeholders.clear();
     if (!m_context.IsNull()) {
         m_context->RemoveAll(false);
         update();
     }
 }
 
+void OccWidget::displayPlaceholder(int key, const Bnd_Box& box)
+{
+    if (!m_isInitialized) {
+        initOCC();
+        m_isInitialized = true;
+    }
+
+    if (m_context.IsNull() || box.IsVoid()) {
+        return;
+    }
+
+    // 扁平零件的包围盒可能有零厚度，给每个方向一个最小尺寸
+    Standard_Real xmin, ymin, zmin, xmax, ymax, zmax;
+    box.Get(xmin, ymin, zmin, xmax, ymax, zmax);
+    Standard_Real minSize = std::max(Precision::Confusion(),
+        1.0e-3 * std::max(xmax - xmin, std::max(ymax - ymin, zmax - zmin)));
+    gp_Pnt corner(xmin, ymin, zmin);
+    BRepPrimAPI_MakeBox boxMaker(corner,
+        std::max(xmax - xmin, minSize), std::max(ymax - ymin, minSize), std::max(zmax - zmin, minSize));
+
+    Handle(AIS_Shape) placeholder = new AIS_Shape(boxMaker.Shape());
+    placeholder->SetColor(Quantity_NOC_GRAY50);
+    m_context->Display(placeholder, AIS_WireFrame, -1, false);
+
+    auto existing = m_placeholders.find(key);
+    if (existing != m_placeholders.end()) {
+        m_context->Remove(existing.value(), false);
+    }
+    m_placeholders.insert(key, placeholder);
+    update();
+}
+
+void OccWidget::replacePlaceholder(int key, const TopoDS_Shape& shape)
+{
+    auto existing = m_placeholders.find(key);
+    if (existing != m_placeholders.end()) {
+        if (!m_context.IsNull()) {
+            m_context->Remove(existing.value(), false);
+        }
+        m_placeholders.erase(existing);
+    }
+
+    if (!m_isInitialized) {
+        initOCC();
+        m_isInitialized = true;
+    }
+
+    if (!m_context.IsNull() && !shape.IsNull()) {
+        // 形状已在加载线程中网格化；关闭自动三角剖分，避免界面线程重新网格化与其他根实体共享的面
+        Handle(AIS_Shape) aisShape = new AIS_Shape(shape);
+        aisShape->Attributes()->SetAutoTriangulation(Standard_False);
+        m_context->Display(aisShape, false);
+        update();
+    }
+}
+
+void OccWidget::clearPlaceholders()
+{
+    if (!m_context.IsNull()) {
+        for (const Handle(AIS_Shape)& placeholder : m_placeholders) {
+            m_context->Remove(placeholder, false);
+        }
+        update();
+    }
+    m_placeholders.clear();
+}
+
 void OccWidget::mousePressEvent(QMouseEvent* event)
 {
     if (event->button() == Qt::LeftButton) {
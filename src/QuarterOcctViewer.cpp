@@ -13,6 +13,7 @@
 #include <QPushButton>
 #include <QWheelEvent>
 #include <QMouseEvent>
+#include <QStatusBar>
 
 // Coin3D and Quarter headers
 #include <Inventor/nodes/SoSeparator.h>
@@ -31,9 +32,14 @@
 #include <Inventor/nodes/SoIndexedLineSet.h>
 #include <Inventor/nodes/SoPointSet.h>
 #include <Inventor/nodes/SoShape.h>
+#include <Inventor/nodes/SoCallback.h>
+#include <Inventor/nodes/SoSwitch.h>
 #include <Inventor/actions/SoWriteAction.h>
+#include <Inventor/actions/SoGLRenderAction.h>
 #include <Inventor/actions/SoRayPickAction.h>
 #include <Inventor/SbViewportRegion.h>
+#include <Inventor/SbViewVolume.h>
+#include <Inventor/SbLine.h>
 #include <Inventor/SoPath.h>
 #include <Inventor/SoInteraction.h>
 #include <Inventor/SoPickedPoint.h>
@@ -70,6 +76,7 @@ using namespace SIM::Coin3D::Quarter;
 #include <BRepGProp.hxx>
 #include <GProp_GProps.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Iterator.hxx>
 #include <TopTools_IndexedMapOfShape.hxx>
 #include <Poly_PolygonOnTriangulation.hxx>
 #include <Poly_Polygon3D.hxx>
@@ -77,10 +84,61 @@ using namespace SIM::Coin3D::Quarter;
 #include <IMeshTools_Parameters.hxx>
 #include <Precision.hxx>
 #include <gp.hxx>
+#include <gp_Lin.hxx>
+
+#include <algorithm>
+#include <vector>
 
 #include "ViewTool.h"
+#include "ShapeUtil.h"
+#include "BackgroundShapeConverter.h"
+
 #include "base.h"
 
+namespace {
+    // Tessellation quality of the model at full detail
+    const double MODEL_DEVIATION = 0.001;
+    const double MODEL_ANGULAR_DEFLECTION = 0.05;
+
+    // Level of detail: deflection scale of each level (finest first) and the projected
+    // bounding box area in pixels from which the level is used
+    const int LOD_LEVEL_COUNT = 3;
+    const double LOD_DEFLECTION_FACTORS[LOD_LEVEL_COUNT] = { 1.0, 4.0, 16.0 };
+    const float LOD_SCREEN_AREAS[LOD_LEVEL_COUNT] = { 40000.0f, 2500.0f, 0.0f };
+    const double LOD_MAX_ANGULAR_DEFLECTION = 0.5;
+
+    // Pick radius in pixels
+    const float PICK_RADIUS = 5.0f;
+
+    // Collects the non-compound leaves of the shape; locations are accumulated by the iterator
+    void collectParts(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& parts)
+    {
+        if (shape.ShapeType() == TopAbs_COMPOUND) {
+            for (TopoDS_Iterator it(shape); it.More(); it.Next()) {
+                collectParts(it.Value(), parts);
+            }
+        }
+        else {
+            parts.push_back(shape);
+        }
+    }
+
+    // Tessellation levels of the model, finest first, derived from its full-detail deflection
+    std::vector<ShapeUtil::DetailLevel> detailLevels(double deflection)
+    {
+        std::vector<ShapeUtil::DetailLevel> levels;
+        for (int i = 0; i < LOD_LEVEL_COUNT; i++) {
+            ShapeUtil::DetailLevel level;
+            level.deflection = deflection * LOD_DEFLECTION_FACTORS[i];
+            level.angularDeflection = std::max(MODEL_ANGULAR_DEFLECTION,
+                std::min(MODEL_ANGULAR_DEFLECTION * LOD_DEFLECTION_FACTORS[i], LOD_MAX_ANGULAR_DEFLECTION));
+            level.minScreenArea = LOD_SCREEN_AREAS[i];
+            levels.push_back(level);
+        }
+        return levels;
+    }
+}
+
 
 
 
@@ -95,13 +153,23 @@ QuarterOcctViewer::QuarterOcctViewer(QWidget *parent)
       m_zoomSlider(nullptr),
       m_wireframeMode(false),
       m_pickRoot(nullptr),
-      m_pickEnabled(true)
+      m_pickEnabled(true),
+      m_levelOfDetail(true),
+      m_converter(nullptr),
+      m_statsLabel(nullptr),
+      m_statsStart(nullptr),
+      m_statsEnd(nullptr),
+      m_pickerGeneration(0)
 {
+    m_converter = new BackgroundShapeConverter(this);
     setupUI();
 }
 
 QuarterOcctViewer::~QuarterOcctViewer()
 {
+    // Stop the conversion and the BVH build before the scene they feed goes away
+    delete m_converter;
+
     // Cleanup Coin3D nodes
     if (m_root) {
         m_root->unref();
@@ -140,6 +208,27 @@ void QuarterOcctViewer::setupUI()
     });
     controlLayout->addWidget(wireframeCheckBox);
     
+    // Add level of detail checkbox
+    QCheckBox* lodCheckBox = new QCheckBox("Level of Detail", controlPanel);
+    lodCheckBox->setChecked(m_levelOfDetail);
+    connect(lodCheckBox, &QCheckBox::toggled, this, &QuarterOcctViewer::setLevelOfDetail);
+    controlLayout->addWidget(lodCheckBox);
+    
+    // Add triangle buffer checkbox; the format applies to shapes displayed afterwards
+    QCheckBox* buffersCheckBox = new QCheckBox("Triangle Buffers", controlPanel);
+    buffersCheckBox->setChecked(ShapeUtil::geometryFormat() == ShapeUtil::GeometryFormat::TriangleBuffer);
+    connect(buffersCheckBox, &QCheckBox::toggled, this, [](bool checked) {
+        ShapeUtil::setGeometryFormat(checked ? ShapeUtil::GeometryFormat::TriangleBuffer
+                                             : ShapeUtil::GeometryFormat::IndexedFaceSet);
+    });
+    controlLayout->addWidget(buffersCheckBox);
+    
+    // Add render statistics checkbox; counting costs render caching, so it is off by default
+    QCheckBox* statsCheckBox = new QCheckBox("Statistics", controlPanel);
+    statsCheckBox->setChecked(ShapeUtil::renderStatisticsEnabled());
+    connect(statsCheckBox, &QCheckBox::toggled, this, &QuarterOcctViewer::setRenderStatistics);
+    controlLayout->addWidget(statsCheckBox);
+    
     // Add zoom slider
     controlLayout->addWidget(new QLabel("Zoom:", controlPanel));
     m_zoomSlider = new QSlider(Qt::Horizontal, controlPanel);
@@ -214,6 +303,17 @@ void QuarterOcctViewer::setupUI()
     m_root = new SoSeparator;
     m_root->ref();
     
+    // Start counting drawn and culled chunks with every render pass while statistics are shown
+    SoCallback* frameStart = new SoCallback;
+    frameStart->setCallback([](void*, SoAction* action) {
+        if (action->isOfType(SoGLRenderAction::getClassTypeId())) {
+            ShapeUtil::resetRenderStatistics();
+        }
+    });
+    m_statsStart = new SoSwitch;
+    m_statsStart->addChild(frameStart);
+    m_root->addChild(m_statsStart);
+    
     // Add camera
     m_camera = new SoPerspectiveCamera;
     m_camera->position.setValue(0, 0, 10);
@@ -250,6 +350,29 @@ void QuarterOcctViewer::setupUI()
     m_modelRoot = new SoSeparator;
     m_pickRoot->addChild(m_modelRoot);
     
+    // Pass the statistics of the finished render pass to the overlay; the label is
+    // updated after the frame, not while the GL context renders
+    SoCallback* frameEnd = new SoCallback;
+    frameEnd->setCallback([](void* data, SoAction* action) {
+        if (action->isOfType(SoGLRenderAction::getClassTypeId())) {
+            QuarterOcctViewer* viewer = static_cast<QuarterOcctViewer*>(data);
+            const ShapeUtil::RenderStatistics stats = ShapeUtil::renderStatistics();
+            QMetaObject::invokeMethod(viewer, [viewer, stats]() {
+                viewer->updateStatistics(stats);
+            }, Qt::QueuedConnection);
+        }
+    }, this);
+    m_statsEnd = new SoSwitch;
+    m_statsEnd->addChild(frameEnd);
+    m_root->addChild(m_statsEnd);
+    
+    // Render statistics overlay in the corner of the 3D view
+    m_statsLabel = new QLabel(m_quarterWidget);
+    m_statsLabel->setStyleSheet("QLabel { background-color: rgba(255, 255, 255, 180); color: black; padding: 4px; }");
+    m_statsLabel->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_statsLabel->move(8, 8);
+    setRenderStatistics(statsCheckBox->isChecked());
+    
     // Set the scene graph to Quarter widget
     m_quarterWidget->setSceneGraph(m_root);
     
@@ -261,680 +384,6 @@ void QuarterOcctViewer::setupUI()
 	resize(800, 600);
 }
 
-SoNode* QuarterOcctViewer::convertOcctShapeToCoin3D(TopoDS_Shape shape)
-{
-    try {
-        SoSeparator* shapeSep = new SoSeparator;
-        
-        if (shape.IsNull()) {
-            return shapeSep;
-        }
-        
-        // Create mesh for the entire shape with appropriate resolution
-        Standard_Real deflection = 0.1; // Adjust this value for better quality vs performance
-        
-        // Since OCCT 7.6 a value of equal 0 is not allowed any more
-        if (deflection < gp::Resolution()) {
-            deflection = Precision::Confusion();
-        }
-        
-        // For very big objects the computed deflection can become very high
-        //deflection = std::min(deflection, 20.0);
-        
-        // Create mesh parameters
-        IMeshTools_Parameters meshParams;
-        meshParams.Deflection = deflection;
-        meshParams.Relative = Standard_False;
-        meshParams.Angle = 0.5; // Angular deflection in radians
-        meshParams.InParallel = Standard_True;
-        meshParams.AllowQualityDecrease = Standard_True;
-        
-        // Generate mesh
-        BRepMesh_IncrementalMesh meshGenerator(shape, meshParams);
-        
-        // First pass: Calculate total number of nodes needed
-        TopTools_IndexedMapOfShape faceMap;
-        TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
-        
-        int numTriangles = 0, numNodes = 0, numNorms = 0, numFaces = 0, numEdges = 0;
-        
-        TopLoc_Location aLoc;
-        shape.Location(aLoc);
-        // Calculate nodes from faces
-        for (int i = 1; i <= faceMap.Extent(); i++) {
-			const TopoDS_Face& face = TopoDS::Face(faceMap(i));
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(face, aLoc);
-            
-			if (mesh.IsNull())
-            {
-                qDebug() << "current mesh can not Triangulation!";
-            }
-            else
-            {
-                numTriangles += mesh->NbTriangles();
-                numNodes += mesh->NbNodes();
-                numNorms += mesh->NbNodes();
-            }
-
-
-            numFaces++;
-        }
-        
-        // Calculate nodes from edges
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
-        numEdges = edgeMap.Extent();
-        
-        int edgeNodes = 0;
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            
-            // Get edge curve
-            Standard_Real first, last;
-            Handle(Geom_Curve) curve = BRep_Tool::Curve(aEdge, first, last);
-            
-            if (!curve.IsNull()) {
-                // Discretize the curve to get point count
-                GeomAdaptor_Curve curveAdaptor(curve);
-                GCPnts_TangentialDeflection discretizer;
-                discretizer.Initialize(curveAdaptor, 0.05, 0.05, first, last);
-                
-                edgeNodes += discretizer.NbPoints();
-            }
-        }
-        numNodes += edgeNodes;
-        
-        // Calculate nodes from vertices
-        TopTools_IndexedMapOfShape vertexMap;
-        TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
-        numNodes += vertexMap.Extent();
-        
-        // Create Coin3D nodes with correct sizes
-        SoCoordinate3* coords = new SoCoordinate3;
-		coords->ref();
-        SoNormal* norm = new SoNormal;
-		norm->ref();
-        SoNormalBinding* normalBinding = new SoNormalBinding;
-		normalBinding->ref();
-        SoIndexedFaceSet* faceSet = new SoIndexedFaceSet;
-		faceSet->ref();
-        SoIndexedLineSet* lineSet = new SoIndexedLineSet;
-		lineSet->ref();
-        SoPointSet* pointSet = new SoPointSet;
-        pointSet->ref();
-        
-        normalBinding->value.setValue(SoNormalBinding::PER_VERTEX_INDEXED);
-        
-        // Allocate memory for nodes and indexes
-        coords->point.setNum(numNodes);
-        norm->vector.setNum(numNorms);
-        faceSet->coordIndex.setNum(numTriangles * 4); // 3 vertices + SO_END_FACE_INDEX
-        
-        // Get raw pointers for fast access
-        SbVec3f* verts = coords->point.startEditing();
-        SbVec3f* norms = norm->vector.startEditing();
-        int32_t* index = faceSet->coordIndex.startEditing();
-        
-        // Initialize normals to zero vector
-        for (int i = 0; i < numNorms; i++) {
-            norms[i] = SbVec3f(0.0, 0.0, 0.0);
-        }
-        
-        // Process faces (second pass)
-        int faceNodeOffset = 0, faceTriaOffset = 0;
-        
-        for (int i = 1; i <= faceMap.Extent(); i++) {
-            TopLoc_Location faceLoc;
-            const TopoDS_Face& actFace = TopoDS::Face(faceMap(i));
-            
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace, faceLoc);
-            if (mesh.IsNull()) {
-                continue;
-            }
-            
-            // Get transformation
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!faceLoc.IsIdentity()) {
-                identity = false;
-                myTransf = faceLoc.Transformation();
-            }
-            
-            int nbNodesInFace = mesh->NbNodes();
-            int nbTriInFace = mesh->NbTriangles();
-            TopAbs_Orientation orient = actFace.Orientation();
-            
-            // Process triangles
-            for (int g = 1; g <= nbTriInFace; g++) {
-                Standard_Integer N1, N2, N3;
-                mesh->Triangle(g).Get(N1, N2, N3);
-                
-                // Adjust orientation if needed
-                if (orient != TopAbs_FORWARD) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
-                
-                // Get vertices
-                gp_Pnt V1(mesh->Node(N1)), V2(mesh->Node(N2)), V3(mesh->Node(N3));
-                
-                // Apply transformation
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                }
-                
-                // Calculate normal
-                gp_Vec v1 = V2.XYZ() - V1.XYZ();
-                gp_Vec v2 = V3.XYZ() - V1.XYZ();
-                gp_Vec triangleNormal = v1 ^ v2;
-                
-                // Normalize if non-zero
-                if (triangleNormal.SquareMagnitude() > Precision::SquareConfusion()) {
-                    triangleNormal.Normalize();
-                } else {
-                    triangleNormal.SetXYZ(gp_XYZ(0.0, 0.0, 1.0));
-                }
-                
-                // Store vertex coordinates
-                int idx1 = faceNodeOffset + N1 - 1;
-                int idx2 = faceNodeOffset + N2 - 1;
-                int idx3 = faceNodeOffset + N3 - 1;
-                
-                verts[idx1] = SbVec3f(V1.X(), V1.Y(), V1.Z());
-                verts[idx2] = SbVec3f(V2.X(), V2.Y(), V2.Z());
-                verts[idx3] = SbVec3f(V3.X(), V3.Y(), V3.Z());
-                
-                // Accumulate normals
-                norms[idx1] += SbVec3f(triangleNormal.X(), triangleNormal.Y(), triangleNormal.Z());
-                norms[idx2] += SbVec3f(triangleNormal.X(), triangleNormal.Y(), triangleNormal.Z());
-                norms[idx3] += SbVec3f(triangleNormal.X(), triangleNormal.Y(), triangleNormal.Z());
-                
-                // Set face index
-                int triIndex = faceTriaOffset * 4;
-                index[triIndex] = idx1;
-                index[triIndex + 1] = idx2;
-                index[triIndex + 2] = idx3;
-                index[triIndex + 3] = SO_END_FACE_INDEX;
-            }
-            
-            // Update offsets
-            faceNodeOffset += nbNodesInFace;
-            faceTriaOffset += nbTriInFace;
-        }
-        
-        // Normalize all normals
-        for (int i = 0; i < numNorms; i++) {
-            if (norms[i].sqrLength() > 1e-12) {
-                norms[i].normalize();
-            } else {
-                norms[i] = SbVec3f(0.0f, 0.0f, 1.0f);
-            }
-        }
-        
-        // Process edges (third pass)
-        std::vector<int32_t> lineSetCoords;
-        int edgeNodeOffset = faceNodeOffset;
-        
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            
-            Standard_Real first, last;
-            Handle(Geom_Curve) curve = BRep_Tool::Curve(aEdge, first, last);
-            
-            if (!curve.IsNull()) {
-                GeomAdaptor_Curve curveAdaptor(curve);
-                GCPnts_TangentialDeflection discretizer;
-                discretizer.Initialize(curveAdaptor, 0.05, 0.05, first, last);
-                
-                if (discretizer.NbPoints() > 0) {
-                    // Store edge vertices
-                    for (Standard_Integer j = 1; j <= discretizer.NbPoints(); j++) {
-                        gp_Pnt pnt = discretizer.Value(j);
-                        if (!aEdge.Location().IsIdentity()) {
-                            pnt.Transform(aEdge.Location().Transformation());
-                        }
-                        
-                        int nodeIndex = edgeNodeOffset++;
-                        verts[nodeIndex] = SbVec3f(pnt.X(), pnt.Y(), pnt.Z());
-                        lineSetCoords.push_back(nodeIndex);
-                    }
-                    lineSetCoords.push_back(-1); // End marker
-                }
-            }
-        }
-        
-        // Process vertices (fourth pass)
-        pointSet->startIndex.setValue(edgeNodeOffset);
-        for (int i = 0; i < vertexMap.Extent(); i++) {
-            const TopoDS_Vertex& aVertex = TopoDS::Vertex(vertexMap(i + 1));
-            gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
-            
-            if (!aVertex.Location().IsIdentity()) {
-                pnt.Transform(aVertex.Location().Transformation());
-            }
-            
-            verts[edgeNodeOffset + i] = SbVec3f(pnt.X(), pnt.Y(), pnt.Z());
-        }
-        
-        // Set line set coordinates
-        lineSet->coordIndex.setNum(lineSetCoords.size());
-        int32_t* lines = lineSet->coordIndex.startEditing();
-        
-        for (size_t i = 0; i < lineSetCoords.size(); i++) {
-            lines[i] = lineSetCoords[i];
-        }
-        
-        // Finish editing all nodes
-        coords->point.finishEditing();
-        norm->vector.finishEditing();
-        faceSet->coordIndex.finishEditing();
-        lineSet->coordIndex.finishEditing();
-        
-        // Add material for better visualization
-        SoMaterial* material = new SoMaterial;
-        material->diffuseColor.setValue(0.8, 0.8, 0.8);
-        material->specularColor.setValue(1.0, 1.0, 1.0);
-        material->shininess.setValue(0.5);
-        
-        // Assemble the scene graph
-        shapeSep->addChild(material);
-        shapeSep->addChild(normalBinding);
-        shapeSep->addChild(norm);
-        shapeSep->addChild(coords);
-        shapeSep->addChild(faceSet);
-        shapeSep->addChild(lineSet);
-        shapeSep->addChild(pointSet);
-        
-        return shapeSep;
-    } catch (const Standard_Failure& e) {
-        QMessageBox::critical(this, "OCCT Exception", e.GetMessageString());
-        return nullptr;
-    } catch (...) {
-        QMessageBox::critical(this, "Error", "Unknown error during shape conversion");
-        return nullptr;
-    }
-}
-
-SoNode* QuarterOcctViewer::convertShapeRecursive(TopoDS_Shape shape, double deviation,double angularDeflection)
-{
-    try {
-        SoSeparator* shapeSep = new SoSeparator;
-        SoCoordinate3* coords = new SoCoordinate3;
-        coords->ref();
-        SoNormal* norm = new SoNormal;
-        norm->ref();
-        SoNormalBinding* normalBinding = new SoNormalBinding;
-        normalBinding->ref();
-        SoIndexedFaceSet* faceSet = new SoIndexedFaceSet;
-        faceSet->ref();
-        SoIndexedLineSet* lineSet = new SoIndexedLineSet;
-        lineSet->ref();
-        SoPointSet* pointSet = new SoPointSet;
-        pointSet->ref();
-
-        if (ViewTool::isShapeEmpty(shape)) {
-            coords->point.setNum(0);
-            norm->vector.setNum(0);
-            faceSet->coordIndex.setNum(0);
-            lineSet->coordIndex.setNum(0);
-            pointSet->startIndex.setValue(0);
-            return shapeSep;
-        }
-
-        int numTriangles = 0, numNodes = 0, numNorms = 0, numFaces = 0, numEdges = 0, numLines = 0;
-
-        std::set<int> faceEdges;
-
-        Standard_Real deflection = ViewTool::getDeflection(shape, deviation);
-
-        if (deflection < gp::Resolution()) {
-            deflection = Precision::Confusion();
-        }
-
-
-        Standard_Real AngDeflectionRads = angularDeflection;
-
-        IMeshTools_Parameters meshParams;
-        meshParams.Deflection = deflection;
-        meshParams.Relative = Standard_False;
-        meshParams.Angle = AngDeflectionRads;
-        meshParams.InParallel = Standard_True;
-        meshParams.AllowQualityDecrease = Standard_True;
-
-        BRepMesh_IncrementalMesh importMesh(shape, meshParams);
-
-
-        TopLoc_Location aLoc;
-        shape.Location(aLoc);
-
-        // count triangles and nodes in the mesh
-        TopTools_IndexedMapOfShape faceMap;
-        TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
-        for (int i = 1; i <= faceMap.Extent(); i++) {
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(faceMap(i)), aLoc);
-
-            if (mesh.IsNull()) {
-                mesh = ViewTool::triangulationOfFace(TopoDS::Face(faceMap(i)));
-            }
-
-            // Note: we must also count empty faces
-            if (!mesh.IsNull()) {
-                numTriangles += mesh->NbTriangles();
-                numNodes += mesh->NbNodes();
-                numNorms += mesh->NbNodes();
-            }
-
-            TopExp_Explorer xp;
-            for (xp.Init(faceMap(i), TopAbs_EDGE); xp.More(); xp.Next()) {
-                faceEdges.insert(Jumpers::ShapeMapHasher{}(xp.Current()));
-            }
-            numFaces++;
-        }
-
-        // get an indexed map of edges
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
-
-        // key is the edge number, value the coord indexes. This is needed to keep the same order as
-        // the edges.
-        std::map<int, std::vector<int32_t>> lineSetMap;
-        std::set<int> edgeIdxSet;
-        std::vector<int32_t> edgeVector;
-
-        // count and index the edges
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            edgeIdxSet.insert(i);
-            numEdges++;
-
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            TopLoc_Location aLoc;
-
-
-            int hash = Jumpers::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = ViewTool::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    int nbNodesInEdge = aPoly->NbNodes();
-                    numNodes += nbNodesInEdge;
-                }
-            }
-        }
-
-        // handling of the vertices
-        TopTools_IndexedMapOfShape vertexMap;
-        TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
-        numNodes += vertexMap.Extent();
-
-        // create memory for the nodes and indexes
-        coords->point.setNum(numNodes);
-        norm->vector.setNum(numNorms);
-        faceSet->coordIndex.setNum(numTriangles * 4);
-        //faceSet->partIndex.setNum(numFaces);
-
-        // get the raw memory for fast fill up
-        SbVec3f* verts = coords->point.startEditing();
-        SbVec3f* norms = norm->vector.startEditing();
-        int32_t* index = faceSet->coordIndex.startEditing();
-        // int32_t* parts = faceSet->partIndex.startEditing();
-
-         // preset the normal vector with null vector
-        for (int i = 0; i < numNorms; i++) {
-            norms[i] = SbVec3f(0.0, 0.0, 0.0);
-        }
-
-        int ii = 0, faceNodeOffset = 0, faceTriaOffset = 0;
-        for (int i = 1; i <= faceMap.Extent(); i++, ii++) {
-            TopLoc_Location aLoc;
-            const TopoDS_Face& actFace = TopoDS::Face(faceMap(i));
-            // get the mesh of the shape
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace, aLoc);
-            if (mesh.IsNull()) {
-                mesh = ViewTool::triangulationOfFace(actFace);
-                continue;
-            }
-
-            //if (mesh.IsNull()) {
-            //    parts[ii] = 0;
-            //    continue;
-            //}
-
-            // getting the transformation of the shape/face
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!aLoc.IsIdentity()) {
-                identity = false;
-                myTransf = aLoc.Transformation();
-            }
-
-            // getting size of node and triangle array of this face
-            int nbNodesInFace = mesh->NbNodes();
-            int nbTriInFace = mesh->NbTriangles();
-            // check orientation
-            TopAbs_Orientation orient = actFace.Orientation();
-
-            int numNodes = mesh->NbNodes();
-            TColgp_Array1OfDir Normals(1, numNodes);
-
-            //if (normalsFromUV) {
-            //    Part::Tools::getPointNormals(actFace, mesh, Normals);
-            //}
-
-            for (int g = 1; g <= nbTriInFace; g++) {
-                // Get the triangle
-                Standard_Integer N1, N2, N3;
-                mesh->Triangle(g).Get(N1, N2, N3);
-
-                // change orientation of the triangle if the face is reversed
-                if (orient != TopAbs_FORWARD) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
-
-
-                gp_Pnt V1(mesh->Node(N1)), V2(mesh->Node(N2)), V3(mesh->Node(N3));
-
-                // get the 3 normals of this triangle
-                gp_Vec NV1, NV2, NV3;
-                //if (normalsFromUV) {
-                //    NV1.SetXYZ(Normals(N1).XYZ());
-                //    NV2.SetXYZ(Normals(N2).XYZ());
-                //    NV3.SetXYZ(Normals(N3).XYZ());
-                //}
-                //else {
-                //    gp_Vec v1 = Base::convertTo<gp_Vec>(V1);
-                //    gp_Vec v2 = Base::convertTo<gp_Vec>(V2);
-                //    gp_Vec v3 = Base::convertTo<gp_Vec>(V3);
-
-                //    gp_Vec normal = (v2 - v1) ^ (v3 - v1);
-                //    NV1 = normal;
-                //    NV2 = normal;
-                //    NV3 = normal;
-                //}
-
-                gp_Vec v1 = Base::convertTo<gp_Vec>(V1);
-                gp_Vec v2 = Base::convertTo<gp_Vec>(V2);
-                gp_Vec v3 = Base::convertTo<gp_Vec>(V3);
-
-                gp_Vec normal = (v2 - v1) ^ (v3 - v1);
-                NV1 = normal;
-                NV2 = normal;
-                NV3 = normal;
-
-                // transform the vertices and normals to the place of the face
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                }
-
-                // add the normals for all points of this triangle
-                norms[faceNodeOffset + N1 - 1] += Base::convertTo<SbVec3f>(NV1);
-                norms[faceNodeOffset + N2 - 1] += Base::convertTo<SbVec3f>(NV2);
-                norms[faceNodeOffset + N3 - 1] += Base::convertTo<SbVec3f>(NV3);
-
-                // set the vertices
-                verts[faceNodeOffset + N1 - 1] = Base::convertTo<SbVec3f>(V1);
-                verts[faceNodeOffset + N2 - 1] = Base::convertTo<SbVec3f>(V2);
-                verts[faceNodeOffset + N3 - 1] = Base::convertTo<SbVec3f>(V3);
-
-                // set the index vector with the 3 point indexes and the end delimiter
-                index[faceTriaOffset * 4 + 4 * (g - 1)] = faceNodeOffset + N1 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 1] = faceNodeOffset + N2 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 2] = faceNodeOffset + N3 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 3] = SO_END_FACE_INDEX;
-            }
-
-            //parts[ii] = nbTriInFace;  // new part
-
-            // handling the edges lying on this face
-            TopExp_Explorer Exp;
-            for (Exp.Init(actFace, TopAbs_EDGE); Exp.More(); Exp.Next()) {
-                const TopoDS_Edge& curEdge = TopoDS::Edge(Exp.Current());
-                // get the overall index of this edge
-                int edgeIndex = edgeMap.FindIndex(curEdge);
-                edgeVector.push_back((int32_t)edgeIndex - 1);
-                // already processed this index ?
-                if (edgeIdxSet.find(edgeIndex) != edgeIdxSet.end()) {
-
-                    // this holds the indices of the edge's triangulation to the current polygon
-                    Handle(Poly_PolygonOnTriangulation) aPoly =
-                        BRep_Tool::PolygonOnTriangulation(curEdge, mesh, aLoc);
-                    if (aPoly.IsNull()) {
-                        continue;  // polygon does not exist
-                    }
-
-                    // getting the indexes of the edge polygon
-                    const TColStd_Array1OfInteger& indices = aPoly->Nodes();
-                    for (Standard_Integer i = indices.Lower(); i <= indices.Upper(); i++) {
-                        int nodeIndex = indices(i);
-                        int index = faceNodeOffset + nodeIndex - 1;
-                        lineSetMap[edgeIndex].push_back(index);
-
-                        // usually the coordinates for this edge are already set by the
-                        // triangles of the face this edge belongs to. However, there are
-                        // rare cases where some points are only referenced by the polygon
-                        // but not by any triangle. Thus, we must apply the coordinates to
-                        // make sure that everything is properly set.
-
-                        gp_Pnt p(mesh->Node(nodeIndex));
-                        if (!identity) {
-                            p.Transform(myTransf);
-                        }
-                        verts[index] = Base::convertTo<SbVec3f>(p);
-                    }
-
-                    // remove the handled edge index from the set
-                    edgeIdxSet.erase(edgeIndex);
-                }
-            }
-
-            edgeVector.push_back(-1);
-
-            // counting up the per Face offsets
-            faceNodeOffset += nbNodesInFace;
-            faceTriaOffset += nbTriInFace;
-        }
-
-        // handling of the free edges
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            Standard_Boolean identity = true;
-            gp_Trsf myTransf;
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            int hash = Jumpers::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = ViewTool::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    if (!aLoc.IsIdentity()) {
-                        identity = false;
-                        myTransf = aLoc.Transformation();
-                    }
-
-                    const TColgp_Array1OfPnt& aNodes = aPoly->Nodes();
-                    int nbNodesInEdge = aPoly->NbNodes();
-
-                    gp_Pnt pnt;
-                    for (Standard_Integer j = 1; j <= nbNodesInEdge; j++) {
-                        pnt = aNodes(j);
-                        if (!identity) {
-                            pnt.Transform(myTransf);
-                        }
-                        int index = faceNodeOffset + j - 1;
-                        verts[index] = Base::convertTo<SbVec3f>(pnt);
-                        lineSetMap[i].push_back(index);
-                    }
-
-                    faceNodeOffset += nbNodesInEdge;
-                }
-            }
-        }
-
-        pointSet->startIndex.setValue(faceNodeOffset);
-        for (int i = 0; i < vertexMap.Extent(); i++) {
-            const TopoDS_Vertex& aVertex = TopoDS::Vertex(vertexMap(i + 1));
-            gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
-
-            verts[faceNodeOffset + i] = Base::convertTo<SbVec3f>(pnt);
-        }
-
-        // normalize all normals
-        for (int i = 0; i < numNorms; i++) {
-            norms[i].normalize();
-        }
-
-        std::vector<int32_t> lineSetCoords;
-        for (const auto& it : lineSetMap) {
-            lineSetCoords.insert(lineSetCoords.end(), it.second.begin(), it.second.end());
-            lineSetCoords.push_back(-1);
-        }
-
-        // preset the index vector size
-        numLines = lineSetCoords.size();
-        lineSet->coordIndex.setNum(numLines);
-        int32_t* lines = lineSet->coordIndex.startEditing();
-
-        int l = 0;
-        for (auto it = lineSetCoords.begin(); it != lineSetCoords.end(); ++it, l++) {
-            lines[l] = *it;
-        }
-
-        // end the editing of the nodes
-        coords->point.finishEditing();
-        norm->vector.finishEditing();
-        faceSet->coordIndex.finishEditing();
-        //faceSet->partIndex.finishEditing();
-        lineSet->coordIndex.finishEditing();
-
-        SoMaterial* material = new SoMaterial;
-        material->diffuseColor.setValue(0.8, 0.8, 0.8);
-        material->specularColor.setValue(1.0, 1.0, 1.0);
-        material->shininess.setValue(0.5);
-
-        shapeSep->addChild(material);
-        shapeSep->addChild(normalBinding);
-        shapeSep->addChild(norm);
-        shapeSep->addChild(coords);
-        shapeSep->addChild(faceSet);
-        shapeSep->addChild(lineSet);
-        shapeSep->addChild(pointSet);
-        return shapeSep;
-    }
-    catch (const Standard_Failure& e) {
-        QMessageBox::critical(this, "OCCT Exception", e.GetMessageString());
-        return nullptr;
-    }
-    catch (...) {
-        QMessageBox::critical(this, "Error", "Unknown error during shape conversion");
-        return nullptr;
-    }
-}
-
 bool QuarterOcctViewer::readSTEPFile(const std::string& filePath, TopoDS_Shape& shape)
 {
     try {
@@ -1015,25 +464,101 @@ bool QuarterOcctViewer::loadIGESFile(const std::string& filePath)
 
 bool QuarterOcctViewer::displayShape(const TopoDS_Shape& shape)
 {
-    // Clear existing model
+    // Clear existing model; this also cancels a conversion that is still running
     clearScene();
-    
-    // Convert OCCT shape to Coin3D node
-    SoNode* modelNode = convertShapeRecursive(shape,0.001,0.05);
-    if (modelNode) {
-        m_modelRoot->addChild(modelNode);
-        
-        // Zoom to fit
-        zoomAll();
-        
+
+    if (ViewTool::isShapeEmpty(shape)) {
         return true;
     }
-    
-    return false;
+
+    // The finest level keeps the quality of the whole model; it is not derived per part,
+    // which would tessellate small parts finer than large ones
+    const std::vector<ShapeUtil::DetailLevel> levels = detailLevels(ViewTool::getDeflection(shape, MODEL_DEVIATION));
+    const bool levelOfDetail = m_levelOfDetail;
+
+    // Every part gets its own node, so it shows up as soon as it is converted and, with
+    // level of detail, Coin picks a level from the part's own screen size
+    std::vector<TopoDS_Shape> parts;
+    collectParts(shape, parts);
+
+    BackgroundShapeConverter::Callbacks callbacks;
+    callbacks.partReady = [this](SoNode* node, int index, int count) {
+        m_modelRoot->addChild(node);
+        if (m_modelRoot->getNumChildren() == 1) {
+            zoomAll();
+        }
+        statusBar()->showMessage(QString("Converting shape: %1 / %2 parts").arg(index + 1).arg(count));
+    };
+    callbacks.finished = [this](int converted, int count) {
+        statusBar()->clearMessage();
+        if (converted == 0) {
+            QMessageBox::critical(this, "Error", "Failed to convert shape for display");
+            return;
+        }
+        if (converted < count) {
+            statusBar()->showMessage(QString("%1 of %2 parts could not be converted").arg(count - converted).arg(count));
+        }
+        zoomAll();
+    };
+
+    m_converter->start(parts, [levels, levelOfDetail](const TopoDS_Shape& part) -> SoNode* {
+        if (levelOfDetail) {
+            return ShapeUtil::convertShapeLevels(part, levels);
+        }
+        return ShapeUtil::convertShape(part, levels.front().deflection, levels.front().angularDeflection);
+    }, callbacks);
+
+    // The pick BVH is built behind the conversion on the same worker, over the finest
+    // triangulation the parts were left with
+    const unsigned int generation = m_pickerGeneration;
+    m_converter->queue([this, shape, generation]() {
+        std::shared_ptr<ShapePicker> picker = std::make_shared<ShapePicker>();
+        try {
+            picker->build(shape);
+        }
+        catch (const Standard_Failure&) {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, picker, generation]() {
+            if (generation == m_pickerGeneration) {
+                m_picker = picker;
+            }
+        }, Qt::QueuedConnection);
+    });
+
+    return true;
+}
+
+void QuarterOcctViewer::setLevelOfDetail(bool enabled)
+{
+    m_levelOfDetail = enabled;
+}
+
+void QuarterOcctViewer::setRenderStatistics(bool enabled)
+{
+    // The chunk counters are built into the geometry, so shapes displayed before keep theirs
+    ShapeUtil::setRenderStatistics(enabled);
+    const int which = enabled ? SO_SWITCH_ALL : SO_SWITCH_NONE;
+    m_statsStart->whichChild = which;
+    m_statsEnd->whichChild = which;
+    m_statsLabel->setVisible(enabled);
+}
+
+void QuarterOcctViewer::updateStatistics(const ShapeUtil::RenderStatistics& stats)
+{
+    m_statsLabel->setText(QString("Chunks: %1 drawn, %2 culled\nTriangles: %3 drawn, %4 culled")
+        .arg(stats.chunks - stats.culledChunks).arg(stats.culledChunks)
+        .arg(stats.triangles - stats.culledTriangles).arg(stats.culledTriangles));
+    m_statsLabel->adjustSize();
 }
 
 void QuarterOcctViewer::clearScene()
 {
+    // Parts of the previous shape that are still being converted are dropped
+    m_converter->cancel();
+    m_picker.reset();
+    m_pickerGeneration++;
+
     // Remove all children from model root
     while (m_modelRoot->getNumChildren() > 0) {
         m_modelRoot->removeChild(0);
@@ -1213,8 +738,64 @@ bool QuarterOcctViewer::eventFilter(QObject* obj, QEvent* event)
     return QMainWindow::eventFilter(obj, event);
 }
 
+ShapePicker::PickResult QuarterOcctViewer::pickShape(int x, int y) const
+{
+    ShapePicker::PickResult result;
+    const int width = m_quarterWidget->width();
+    const int height = m_quarterWidget->height();
+    if (!m_picker || width <= 0 || height <= 0) {
+        return result;
+    }
+
+    // The model is not transformed, so the camera ray is already in shape coordinates
+    const SbViewVolume volume = m_camera->getViewVolume(static_cast<float>(width) / static_cast<float>(height));
+    SbLine line;
+    volume.projectPointToLine(SbVec2f((x + 0.5f) / width, (y + 0.5f) / height), line);
+    const SbVec3f& origin = line.getPosition();
+    const SbVec3f& direction = line.getDirection();
+    const gp_Lin ray(gp_Pnt(origin[0], origin[1], origin[2]), gp_Dir(direction[0], direction[1], direction[2]));
+
+    result = m_picker->pick(ray);
+    if (result.hit) {
+        // Edges are accepted within the radius the scene pick used, in pixels
+        const SbVec3f hitPoint(static_cast<float>(result.point.X()), static_cast<float>(result.point.Y()),
+                               static_cast<float>(result.point.Z()));
+        const double tolerance = volume.getWorldToScreenScale(hitPoint, PICK_RADIUS / height);
+        m_picker->pickEdge(ray, result, tolerance);
+    }
+
+    // Free edges have no triangles to hit; the pick radius is given at the ray origin and
+    // grows with the distance from it
+    const double originTolerance = volume.getWorldToScreenScale(origin, PICK_RADIUS / height);
+    const double toleranceSlope = volume.getWorldToScreenScale(origin + direction, PICK_RADIUS / height) - originTolerance;
+    m_picker->pickFreeEdge(ray, result, originTolerance, std::max(0.0, toleranceSlope));
+    return result;
+}
+
 void QuarterOcctViewer::performPick(int x, int y)
 {
+    if (m_picker) {
+        ShapePicker::PickResult result = pickShape(x, y);
+        if (!result.hit) {
+            return;
+        }
+
+        QString message;
+        if (!result.face.IsNull()) {
+            message += QString("Picked face: %1 of %2\n").arg(result.faceIndex).arg(m_picker->faces().Extent());
+        }
+        if (!result.edge.IsNull()) {
+            message += QString("Picked edge: %1 of %2\n").arg(result.edgeIndex).arg(m_picker->edges().Extent());
+        }
+        message += QString("Intersection point: (%1, %2, %3)\n")
+            .arg(result.point.X(), 0, 'f', 3).arg(result.point.Y(), 0, 'f', 3).arg(result.point.Z(), 0, 'f', 3);
+        message += QString("Normal vector: (%1, %2, %3)")
+            .arg(result.normal.X(), 0, 'f', 3).arg(result.normal.Y(), 0, 'f', 3).arg(result.normal.Z(), 0, 'f', 3);
+        QMessageBox::information(this, "Object Picked", message);
+        return;
+    }
+
+    // Until the BVH of the shape is built, the scene graph is picked
     // Create viewport region from widget size
     SbViewportRegion viewport(m_quarterWidget->size().width(), m_quarterWidget->size().height());
     // Create ray pick action for the current viewport
@@ -1222,7 +803,7 @@ void QuarterOcctViewer::performPick(int x, int y)
     pickAction.setPoint(SbVec2s(x, y));
     
     // Set up pick action parameters for better picking accuracy
-    pickAction.setRadius(5.0f); // Set pick radius for easier picking
+    pickAction.setRadius(PICK_RADIUS); // Set pick radius for easier picking
     pickAction.setPickAll(false); // Only pick the nearest object
     
     // Apply the pick action to the scene graph
@@ -1244,11 +825,13 @@ void QuarterOcctViewer::performPick(int x, int y)
                 
                 // Get the intersection point in world coordinates
                 SbVec3f intersection = pickedPoint->getPoint();
-                message += QString("Intersection point: (%.3f, %.3f, %.3f)\n").arg(intersection[0]).arg(intersection[1]).arg(intersection[2]);
+                message += QString("Intersection point: (%1, %2, %3)\n")
+                    .arg(intersection[0], 0, 'f', 3).arg(intersection[1], 0, 'f', 3).arg(intersection[2], 0, 'f', 3);
                 
                 // Get the normal at the intersection point
                 SbVec3f normal = pickedPoint->getNormal();
-                message += QString("Normal vector: (%.3f, %.3f, %.3f)").arg(normal[0]).arg(normal[1]).arg(normal[2]);
+                message += QString("Normal vector: (%1, %2, %3)")
+                    .arg(normal[0], 0, 'f', 3).arg(normal[1], 0, 'f', 3).arg(normal[2], 0, 'f', 3);
                 
                 // Show the picked information
                 QMessageBox::information(this, "Object Picked", message);
@@ -1,4 +1,7 @@
 #include "STEPAnalyzer.h"
+#include "TriangleIntersectionChecker.h"
+#include "AnalysisRecordWriter.h"
+#include "ParallelStepTransfer.h"
 #include <iostream>
 #include <sstream>
 #include <chrono>
@@ -16,9 +19,9 @@
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Vertex.hxx>
 #include <TopExp.hxx>
+#include <TopoDS_Iterator.hxx>
 #include <Bnd_Box.hxx>
 #include <BRepBndLib.hxx>
-#include <BRepExtrema_DistShapeShape.hxx>
 #include <TopTools_IndexedMapOfShape.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <XCAFDoc_ShapeTool.hxx>
@@ -30,6 +33,23 @@
 #include <Interface_InterfaceModel.hxx>
 #include <STEPControl_Writer.hxx>
 #include <StlAPI_Writer.hxx>
+#include <XSControl_WorkSession.hxx>
+#include <XSControl_TransferReader.hxx>
+#include <Transfer_TransientProcess.hxx>
+#include <TransferBRep.hxx>
+#include <OSD_Parallel.hxx>
+#include <Standard_ErrorHandler.hxx>
+#include <NCollection_DataMap.hxx>
+#include <TopTools_ShapeMapHasher.hxx>
+#include <TopLoc_Location.hxx>
+#include <numeric>
+#include <BRep_Tool.hxx>
+#include <BRepAdaptor_Curve.hxx>
+#include <GCPnts_AbscissaPoint.hxx>
+#include <Precision.hxx>
+#include <Poly_Triangulation.hxx>
+#include <gp_XYZ.hxx>
+#include <cmath>
 
 // Helper function to convert shape type to string
 std::string ShapeTypeToString(TopAbs_ShapeEnum type) {
@@ -46,18 +66,33 @@ std::string ShapeTypeToString(TopAbs_ShapeEnum type) {
     }
 }
 
+// Helper function to convert entity status to string
+std::string EntityStatusToString(EntityStatus status) {
+    switch (status) {
+    case EntityStatus::EXPORTABLE: return "Exportable";
+    case EntityStatus::PROBLEMATIC: return "Problematic";
+    case EntityStatus::UNSUPPORTED: return "Unsupported";
+    case EntityStatus::SKIPPED: return "Skipped";
+    default: return "Unknown";
+    }
+}
+
 STEPAnalyzer::STEPAnalyzer()
     : m_linearDeflection(0.01)
     , m_angularDeflection(0.5)
     , m_relativeMode(true)
     , m_includeSurfaces(false)
     , m_autoFix(false)
+    , m_parallel(true)
+    , m_parallelTransfer(false)
+    , m_quickMode(false)
+    , m_fastMassProperties(false)
     , m_loaded(false)
 {
-    // Set STEP reading parameters
-    Interface_Static::SetIVal("read.step.nonmanifold", 1);
-    Interface_Static::SetIVal("read.step.product_mode", 1);
-    Interface_Static::SetIVal("read.step.shape.repr", 1);
+    // Set STEP reading parameters (applied per reader, not process-wide)
+    m_readerOptions.nonManifold = true;
+    m_readerOptions.productMode = true;
+    m_readerOptions.shapeRepresentation = 1;
 }
 
 STEPAnalyzer::~STEPAnalyzer() {}
@@ -66,20 +101,33 @@ bool STEPAnalyzer::LoadSTEP(const std::string& filepath) {
     auto start = std::chrono::high_resolution_clock::now();
 
     // Read STEP file
-    IFSelect_ReturnStatus status = m_reader.ReadFile(filepath.c_str());
+    IFSelect_ReturnStatus status = m_readerOptions.ReadFile(m_reader, filepath);
     if (status != IFSelect_RetDone) {
         std::cerr << "Error: Failed to read STEP file: " << filepath << std::endl;
         return false;
     }
 
     // Transfer all entities
-    m_reader.TransferRoots();
+    ParallelStepTransfer transfer(m_reader);
+    transfer.SetParallel(m_parallelTransfer);
+    transfer.Perform();
 
     // Get root shape
-    m_rootShape = m_reader.OneShape();
-
-    // Get entity list
-    m_entitySequence = m_reader.GiveList("xst-model-roots");
+    m_rootShape = transfer.OneShape();
+
+    // Get entity list; a parallel transfer leaves nothing in the reader's transfer
+    // process, so its entities are the transferred roots with their shapes
+    m_transferredShapes.clear();
+    if (transfer.WasParallel()) {
+        m_entitySequence = new TColStd_HSequenceOfTransient;
+        for (int i = 1; i <= m_reader.NbRootsForTransfer(); i++) {
+            m_entitySequence->Append(m_reader.RootForTransfer(i));
+        }
+        m_transferredShapes = transfer.GetShapes();
+    }
+    else {
+        m_entitySequence = m_reader.GiveList("xst-model-roots");
+    }
 
     m_loaded = true;
 
@@ -98,130 +146,379 @@ AnalysisResult STEPAnalyzer::Analyze(bool quickMode) {
         return m_result;
     }
 
+    m_quickMode = quickMode;
+
     auto start = std::chrono::high_resolution_clock::now();
 
+    // Root entities are expanded into their parts below: an assembly usually comes as a
+    // single root compound, which would otherwise be analyzed as one serial entity
+    std::vector<TopoDS_Shape> parts;
+    std::vector<std::string> partTypes;
+
     // Check if entity sequence is empty
     if (m_entitySequence.IsNull() || m_entitySequence->Length() == 0) {
         std::cout << "Info: No entities found, using root shape" << std::endl;
 
-        EntityInfo info = AnalyzeEntity(m_rootShape, 0);
-        m_result.totalEntities = 1;
-
-        if (info.status == EntityStatus::EXPORTABLE) {
-            m_result.exportableEntities.push_back(info);
-            m_result.successfulMeshCount++;
-        }
-        else if (info.status == EntityStatus::PROBLEMATIC) {
-            m_result.problematicEntities.push_back(info);
-        }
-        else if (info.status == EntityStatus::UNSUPPORTED) {
-            m_result.unsupportedEntities.push_back(info);
-        }
-        else {
-            m_result.skippedEntities.push_back(info);
-        }
+        ExpandToParts(m_rootShape, parts);
+        partTypes.resize(parts.size(), "Unknown");
     }
     else {
-        // Analyze all entities
         int entityCount = m_entitySequence->Length();
-        m_result.totalEntities = entityCount;
+        std::cout << "Start analyzing " << entityCount << " root entities..." << std::endl;
 
-        std::cout << "Start analyzing " << entityCount << " entities..." << std::endl;
+        // Resolve the shape of every root entity on this thread; the reader and its
+        // transfer process are not thread-safe, only the per-shape analysis is
+        Handle(Transfer_TransientProcess) transferProcess = m_reader.WS()->TransferReader()->TransientProcess();
 
         for (int i = 1; i <= entityCount; i++) {
             Handle(Standard_Transient) entity = m_entitySequence->Value(i);
-            
-            // Note: Skipping entity-by-entity transfer as method signature doesn't match
-            continue;
+
+            // Roots transferred in parallel already carry their shape
+            TopoDS_Shape shape;
+            if (i <= static_cast<int>(m_transferredShapes.size())) {
+                shape = m_transferredShapes[i - 1];
+            }
+            else {
+                if (!transferProcess.IsNull()) {
+                    shape = TransferBRep::ShapeResult(transferProcess, entity);
+                }
+                if (shape.IsNull() && m_reader.TransferEntity(entity)) {
+                    transferProcess = m_reader.WS()->TransferReader()->TransientProcess();
+                    shape = TransferBRep::ShapeResult(transferProcess, entity);
+                }
+            }
+
+            ExpandToParts(shape, parts);
+            partTypes.resize(parts.size(), entity->DynamicType()->Name());
         }
     }
 
+    // Parts are the unit of analysis and of reporting
+    int partCount = static_cast<int>(parts.size());
+    m_result.totalEntities = partCount;
+    std::cout << "Analyzing " << partCount << " parts..." << std::endl;
+
+    std::vector<EntityInfo> infos = AnalyzeEntities(parts);
+    for (int i = 0; i < partCount; i++) {
+        infos[i].type = partTypes[i];
+        MergeEntity(infos[i]);
+    }
+
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end - start;
     m_result.processingTime = elapsed.count();
 
     std::cout << "Analysis completed, time: " << elapsed.count() << "s" << std::endl;
     std::cout << "Total entities: " << m_result.totalEntities << std::endl;
-    std::cout << "Exportable entities: " << m_result.exportableEntities.size() << std::endl;
-    std::cout << "Problematic entities: " << m_result.problematicEntities.size() << std::endl;
-    std::cout << "Unsupported entities: " << m_result.unsupportedEntities.size() << std::endl;
-    std::cout << "Skipped entities: " << m_result.skippedEntities.size() << std::endl;
+    std::cout << "Exportable entities: " << m_result.exportableCount << std::endl;
+    std::cout << "Problematic entities: " << m_result.problematicCount << std::endl;
+    std::cout << "Unsupported entities: " << m_result.unsupportedCount << std::endl;
+    std::cout << "Skipped entities: " << m_result.skippedCount << std::endl;
 
     return m_result;
 }
 
+bool STEPAnalyzer::AnalyzeStreaming(const std::string& filepath, AnalysisRecordWriter& writer, bool quickMode) {
+    m_result = AnalysisResult();
+    m_quickMode = quickMode;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // A local reader, so nothing outlives the call; m_reader and m_rootShape stay untouched
+    STEPControl_Reader reader;
+    if (m_readerOptions.ReadFile(reader, filepath) != IFSelect_RetDone) {
+        std::cerr << "Error: Failed to read STEP file: " << filepath << std::endl;
+        return false;
+    }
+
+    int rootCount = reader.NbRootsForTransfer();
+    std::cout << "Start streaming analysis of " << rootCount << " roots..." << std::endl;
+
+    // Each root is transferred, analyzed, written out and released before the
+    // next one, so peak memory is bounded by the largest single root; the parts of
+    // a root are analyzed in parallel and reported one by one
+    for (int i = 1; i <= rootCount; i++) {
+        std::vector<EntityInfo> infos;
+        if (reader.TransferRoot(i)) {
+            std::vector<TopoDS_Shape> parts;
+            ExpandToParts(reader.Shape(reader.NbShapes()), parts);
+            infos = AnalyzeEntities(parts);
+        }
+        else {
+            infos.resize(1);
+            InitEntityInfo(infos[0], TopoDS_Shape(), 0);
+            infos[0].status = EntityStatus::SKIPPED;
+            infos[0].issues.push_back("Transfer failed");
+        }
+
+        const std::string typeName = reader.RootForTransfer(i)->DynamicType()->Name();
+        for (EntityInfo& info : infos) {
+            m_result.totalEntities++;
+            info.id = m_result.totalEntities;
+            info.name = "Entity_" + std::to_string(info.id);
+            info.type = typeName;
+
+            WriteEntityRecord(writer, info, i);
+            info.shape.Nullify();
+            MergeEntity(info, false);
+        }
+        infos.clear();
+
+        // Drop the reader's shape list, the results the transfer reader recorded for the
+        // root and the transfer map; shared sub-parts are re-transferred by later roots
+        // instead of being pinned for the whole run. Mode 1 keeps the model and the process.
+        reader.ClearShapes();
+        const Handle(XSControl_TransferReader)& transferReader = reader.WS()->TransferReader();
+        transferReader->Clear(1);
+        Handle(Transfer_TransientProcess) transferProcess = transferReader->TransientProcess();
+        if (!transferProcess.IsNull()) {
+            transferProcess->Clear();
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    m_result.processingTime = elapsed.count();
+
+    writer.beginRecord("summary");
+    writer.field("analyzer", "STEPAnalyzer");
+    writer.field("file", filepath);
+    writer.field("roots", rootCount);
+    writer.field("exportable", m_result.exportableCount);
+    writer.field("problematic", m_result.problematicCount);
+    writer.field("unsupported", m_result.unsupportedCount);
+    writer.field("skipped", m_result.skippedCount);
+    writer.field("totalVolume", m_result.totalVolume);
+    writer.field("seconds", m_result.processingTime);
+    writer.endRecord();
+    writer.flush();
+
+    std::cout << "Streaming analysis completed, time: " << elapsed.count() << "s" << std::endl;
+    return true;
+}
+
 EntityInfo STEPAnalyzer::AnalyzeEntity(const TopoDS_Shape& shape, int entityId) {
     EntityInfo info;
-    info.id = entityId;
-    info.name = "Entity_" + std::to_string(entityId);
-    info.type = "Unknown";
-    info.shapeType = shape.ShapeType();
-    info.shape = shape;
-    info.isManifold = false;
-    info.isClosed = false;
-    info.faceCount = 0;
-    info.edgeCount = 0;
-    info.vertexCount = 0;
+    InitEntityInfo(info, shape, entityId);
+
+    // Checks run in tiers of increasing cost; an entity leaves the pipeline at
+    // the first tier that rejects it, so expensive checks only see survivors
+    auto tierStart = std::chrono::high_resolution_clock::now();
+    auto finishTier = [&](CheckTier tier, bool passed) {
+        auto now = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed = now - tierStart;
+        info.tierTime[tier] += elapsed.count();
+        info.deepestTier = tier;
+        if (!passed && info.rejectedAtTier < 0) {
+            info.rejectedAtTier = tier;
+        }
+        tierStart = now;
+        return passed;
+    };
 
-    // Skip if shape is null
-    if (shape.IsNull()) {
-        info.status = EntityStatus::SKIPPED;
-        info.issues.push_back("Null shape");
+    // Tier 0: constant-cost sanity checks
+    if (!finishTier(TIER_BASIC, CheckBasic(shape, info))) {
         return info;
     }
 
-    // Skip surfaces if not included
-    if (!m_includeSurfaces && shape.ShapeType() == TopAbs_FACE) {
-        info.status = EntityStatus::SKIPPED;
-        info.issues.push_back("Surfaces skipped");
+    // Tier 1: linear topology checks
+    if (!finishTier(TIER_TOPOLOGY, CheckTopology(shape, info))) {
+        info.status = EntityStatus::PROBLEMATIC;
         return info;
     }
 
-    // Check if shape is supported
-    if (!IsSupportedType(shape.ShapeType())) {
-        info.status = EntityStatus::UNSUPPORTED;
-        info.issues.push_back("Unsupported shape type: " + ShapeTypeToString(shape.ShapeType()));
-        return info;
+    // Tier 2: mesh test, then mass properties (fast mode reuses the test mesh)
+    bool meshed = PerformMeshTest(shape, info);
+    if (!m_quickMode) {
+        ComputeMassProperties(shape, info);
+    }
+    finishTier(TIER_MESH, meshed);
+
+    // Tier 3: self-intersection, only for meshed shapes the topology checks flagged;
+    // the check works on the test mesh, so an unmeshed shape has nothing to check
+    bool selfIntersecting = false;
+    if (!m_quickMode && meshed && !info.isManifold) {
+        selfIntersecting = CheckSelfIntersection(shape, info);
+        if (selfIntersecting) {
+            info.issues.push_back("Self-intersecting shape");
+        }
+        finishTier(TIER_SELF_INTERSECTION, !selfIntersecting);
     }
 
-    // Count elements
-    CountElements(shape, info);
+    info.status = (meshed && !selfIntersecting) ? EntityStatus::EXPORTABLE : EntityStatus::PROBLEMATIC;
+    return info;
+}
 
-    // Check manifoldness
-    info.isManifold = CheckManifold(shape);
-    if (!info.isManifold) {
-        info.issues.push_back("Non-manifold shape");
+std::vector<EntityInfo> STEPAnalyzer::AnalyzeEntities(const std::vector<TopoDS_Shape>& shapes) {
+    const int entityCount = static_cast<int>(shapes.size());
+    std::vector<EntityInfo> infos(entityCount);
+
+    // Entities that share faces (e.g. instances of one part) would race on the
+    // triangulation written by the mesh test, so they are analyzed in one task
+    int groupCount = 0;
+    std::vector<int> groupOf = GroupEntitiesBySharedFaces(shapes, groupCount);
+
+    std::vector<std::vector<int>> groups(groupCount);
+    for (int i = 0; i < entityCount; i++) {
+        groups[groupOf[i]].push_back(i);
     }
 
-    // Check if closed
-    info.isClosed = CheckClosed(shape);
+    auto analyzeGroup = [&](int groupIndex) {
+        for (int i : groups[groupIndex]) {
+            infos[i] = AnalyzeEntityIsolated(shapes[i], i + 1);
+        }
+    };
 
-    // Calculate volume and surface area if applicable
-    if (shape.ShapeType() == TopAbs_SOLID || shape.ShapeType() == TopAbs_COMPOUND || shape.ShapeType() == TopAbs_COMPSOLID) {
-        info.volume = CalculateVolume(shape);
-        info.surfaceArea = CalculateSurfaceArea(shape);
+    if (m_parallel && groupCount > 1) {
+        std::cout << "Analyzing " << groupCount << " independent entity groups in parallel" << std::endl;
+        OSD_Parallel::For(0, groupCount, analyzeGroup);
     }
-    else if (shape.ShapeType() == TopAbs_FACE) {
-        info.surfaceArea = CalculateSurfaceArea(shape);
+    else {
+        for (int g = 0; g < groupCount; g++) {
+            analyzeGroup(g);
+        }
     }
 
-    // Check exportability
-    if (CheckExportability(shape, info)) {
-        // Perform mesh test
-        if (PerformMeshTest(shape, info)) {
-            info.status = EntityStatus::EXPORTABLE;
+    return infos;
+}
+
+void STEPAnalyzer::ExpandToParts(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& parts) {
+    // Compounds are assemblies or groupings; their non-compound leaves are the parts.
+    // The iterator composes the locations of nested instances.
+    if (!shape.IsNull() && shape.ShapeType() == TopAbs_COMPOUND) {
+        const size_t before = parts.size();
+        for (TopoDS_Iterator it(shape); it.More(); it.Next()) {
+            ExpandToParts(it.Value(), parts);
         }
-        else {
-            info.status = EntityStatus::PROBLEMATIC;
+        if (parts.size() > before) {
+            return;
         }
     }
-    else {
-        info.status = EntityStatus::PROBLEMATIC;
+
+    // A leaf, or an empty compound, is reported as it is
+    parts.push_back(shape);
+}
+
+EntityInfo STEPAnalyzer::AnalyzeEntityIsolated(const TopoDS_Shape& shape, int entityId) {
+    // A failure in one entity must not abort the whole audit: report it as a
+    // problematic entity and carry on with the rest
+    std::string failure;
+    try {
+        OCC_CATCH_SIGNALS
+        return AnalyzeEntity(shape, entityId);
+    }
+    catch (const Standard_Failure& e) {
+        failure = std::string("Analysis exception: ") + e.GetMessageString();
+    }
+    catch (const std::exception& e) {
+        failure = std::string("Analysis exception: ") + e.what();
+    }
+    catch (...) {
+        failure = "Unknown analysis exception";
     }
 
+    EntityInfo info;
+    InitEntityInfo(info, shape, entityId);
+    info.status = EntityStatus::PROBLEMATIC;
+    info.issues.push_back(failure);
     return info;
 }
 
+std::vector<int> STEPAnalyzer::GroupEntitiesBySharedFaces(const std::vector<TopoDS_Shape>& shapes, int& groupCount) {
+    const int entityCount = static_cast<int>(shapes.size());
+
+    // Union-find over entities, joined whenever two of them reference the same face
+    std::vector<int> parent(entityCount);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto findRoot = [&parent](int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    // Faces are keyed without location so that located instances of one part collide
+    NCollection_DataMap<TopoDS_Shape, int, TopTools_ShapeMapHasher> faceOwner;
+    for (int i = 0; i < entityCount; i++) {
+        if (shapes[i].IsNull()) {
+            continue;
+        }
+        for (TopExp_Explorer exp(shapes[i], TopAbs_FACE); exp.More(); exp.Next()) {
+            TopoDS_Shape face = exp.Current().Located(TopLoc_Location());
+            face.Orientation(TopAbs_FORWARD);
+            const int* owner = faceOwner.Seek(face);
+            if (owner == nullptr) {
+                faceOwner.Bind(face, i);
+            }
+            else {
+                int a = findRoot(*owner);
+                int b = findRoot(i);
+                if (a != b) {
+                    parent[b] = a;
+                }
+            }
+        }
+    }
+
+    std::vector<int> groupOf(entityCount, -1);
+    std::vector<int> groupOfRoot(entityCount, -1);
+    groupCount = 0;
+    for (int i = 0; i < entityCount; i++) {
+        int root = findRoot(i);
+        if (groupOfRoot[root] < 0) {
+            groupOfRoot[root] = groupCount++;
+        }
+        groupOf[i] = groupOfRoot[root];
+    }
+
+    return groupOf;
+}
+
+void STEPAnalyzer::MergeEntity(const EntityInfo& info, bool keepEntity) {
+    if (info.status == EntityStatus::EXPORTABLE) {
+        if (keepEntity) {
+            m_result.exportableEntities.push_back(info);
+        }
+        m_result.exportableCount++;
+        m_result.successfulMeshCount++;
+    }
+    else if (info.status == EntityStatus::PROBLEMATIC) {
+        if (keepEntity) {
+            m_result.problematicEntities.push_back(info);
+        }
+        m_result.problematicCount++;
+    }
+    else if (info.status == EntityStatus::UNSUPPORTED) {
+        if (keepEntity) {
+            m_result.unsupportedEntities.push_back(info);
+        }
+        m_result.unsupportedCount++;
+    }
+    else {
+        if (keepEntity) {
+            m_result.skippedEntities.push_back(info);
+        }
+        m_result.skippedCount++;
+    }
+
+    m_result.totalVolume += info.volume;
+    m_result.totalVolumeErrorBound += info.volumeErrorBound;
+
+    for (int tier = 0; tier <= info.deepestTier && tier < CHECK_TIER_COUNT; tier++) {
+        m_result.tierEntityCount[tier]++;
+        m_result.tierTime[tier] += info.tierTime[tier];
+    }
+    if (info.rejectedAtTier >= 0 && info.rejectedAtTier < CHECK_TIER_COUNT) {
+        m_result.tierRejectCount[info.rejectedAtTier]++;
+    }
+
+    m_result.entityTypeCount[info.type]++;
+    for (const std::string& issue : info.issues) {
+        m_result.issueCategories[issue].push_back(info.name);
+    }
+}
+
 bool STEPAnalyzer::TryFixEntity(EntityInfo& entity) {
     if (entity.status != EntityStatus::PROBLEMATIC) {
         return false;
@@ -295,6 +592,36 @@ bool STEPAnalyzer::ExportSTL(const std::string& outputPath) {
     return true;
 }
 
+void STEPAnalyzer::WriteEntityRecord(AnalysisRecordWriter& writer, const EntityInfo& info, int rootIndex) const {
+    writer.beginRecord("entity");
+    writer.field("analyzer", "STEPAnalyzer");
+    writer.field("id", info.id);
+    writer.field("root", rootIndex);
+    writer.field("type", info.type);
+    writer.field("shapeType", ShapeTypeToString(info.shapeType));
+    writer.field("status", EntityStatusToString(info.status));
+    writer.field("faces", info.faceCount);
+    writer.field("edges", info.edgeCount);
+    writer.field("vertices", info.vertexCount);
+    writer.field("manifold", info.isManifold);
+    writer.field("closed", info.isClosed);
+    writer.field("volume", info.volume);
+    writer.field("surfaceArea", info.surfaceArea);
+    if (m_fastMassProperties) {
+        writer.field("volumeErrorBound", info.volumeErrorBound);
+    }
+
+    std::string issues;
+    for (const std::string& issue : info.issues) {
+        if (!issues.empty()) {
+            issues += "; ";
+        }
+        issues += issue;
+    }
+    writer.field("issues", issues);
+    writer.endRecord();
+}
+
 std::string STEPAnalyzer::GenerateReport() const {
     std::ostringstream report;
 
@@ -303,13 +630,34 @@ std::string STEPAnalyzer::GenerateReport() const {
     report << std::endl;
     report << "Processing Time: " << m_result.processingTime << " seconds" << std::endl;
     report << "Total Entities: " << m_result.totalEntities << std::endl;
-    report << "Exportable Entities: " << m_result.exportableEntities.size() << std::endl;
-    report << "Problematic Entities: " << m_result.problematicEntities.size() << std::endl;
-    report << "Unsupported Entities: " << m_result.unsupportedEntities.size() << std::endl;
-    report << "Skipped Entities: " << m_result.skippedEntities.size() << std::endl;
+    report << "Exportable Entities: " << m_result.exportableCount << std::endl;
+    report << "Problematic Entities: " << m_result.problematicCount << std::endl;
+    report << "Unsupported Entities: " << m_result.unsupportedCount << std::endl;
+    report << "Skipped Entities: " << m_result.skippedCount << std::endl;
     report << "Successful Mesh Count: " << m_result.successfulMeshCount << std::endl;
     report << std::endl;
 
+    // Mass properties
+    report << "Mass Properties: " << (m_fastMassProperties ? "Triangulation" : "Exact") << std::endl;
+    report << "  Total Volume: " << m_result.totalVolume;
+    if (m_fastMassProperties) {
+        report << " (error bound: " << m_result.totalVolumeErrorBound << ")";
+    }
+    report << std::endl << std::endl;
+
+    // Check pipeline statistics
+    static const char* tierNames[CHECK_TIER_COUNT] = {
+        "Basic", "Topology", "Mesh", "Self-Intersection"
+    };
+    report << "Check Pipeline:" << std::endl;
+    for (int tier = 0; tier < CHECK_TIER_COUNT; tier++) {
+        report << "  " << tierNames[tier] << ": "
+            << m_result.tierEntityCount[tier] << " checked, "
+            << m_result.tierRejectCount[tier] << " rejected, "
+            << m_result.tierTime[tier] << "s" << std::endl;
+    }
+    report << std::endl;
+
     // Entity type statistics
     report << "Entity Type Statistics:" << std::endl;
     for (const auto& entry : m_result.entityTypeCount) {
@@ -328,28 +676,84 @@ void STEPAnalyzer::SetMeshParams(double linearDeflection, double angularDeflecti
 
 // Private methods
 
-bool STEPAnalyzer::CheckExportability(const TopoDS_Shape& shape, EntityInfo& info) {
-    bool exportable = true;
+void STEPAnalyzer::InitEntityInfo(EntityInfo& info, const TopoDS_Shape& shape, int entityId) {
+    info.id = entityId;
+    info.name = "Entity_" + std::to_string(entityId);
+    info.type = "Unknown";
+    info.shapeType = shape.IsNull() ? TopAbs_SHAPE : shape.ShapeType();
+    info.shape = shape;
+    info.volume = 0.0;
+    info.surfaceArea = 0.0;
+    info.centroid = gp_Pnt();
+    info.volumeErrorBound = 0.0;
+    info.isManifold = false;
+    info.isClosed = false;
+    info.faceCount = 0;
+    info.edgeCount = 0;
+    info.vertexCount = 0;
+    info.deepestTier = -1;
+    info.rejectedAtTier = -1;
+    for (int tier = 0; tier < CHECK_TIER_COUNT; tier++) {
+        info.tierTime[tier] = 0.0;
+    }
+}
+
+bool STEPAnalyzer::CheckBasic(const TopoDS_Shape& shape, EntityInfo& info) {
+    // Skip if shape is null
+    if (shape.IsNull()) {
+        info.status = EntityStatus::SKIPPED;
+        info.issues.push_back("Null shape");
+        return false;
+    }
+
+    // Skip surfaces if not included
+    if (!m_includeSurfaces && shape.ShapeType() == TopAbs_FACE) {
+        info.status = EntityStatus::SKIPPED;
+        info.issues.push_back("Surfaces skipped");
+        return false;
+    }
+
+    // Check if shape is supported
+    if (!IsSupportedType(shape.ShapeType())) {
+        info.status = EntityStatus::UNSUPPORTED;
+        info.issues.push_back("Unsupported shape type: " + ShapeTypeToString(shape.ShapeType()));
+        return false;
+    }
 
     // Check if shape has valid geometry
     if (!HasValidGeometry(shape)) {
-        exportable = false;
+        info.status = EntityStatus::PROBLEMATIC;
         info.issues.push_back("Invalid geometry");
+        return false;
     }
 
-    // Check for self-intersections
-    if (CheckSelfIntersection(shape)) {
-        exportable = false;
-        info.issues.push_back("Self-intersecting shape");
+    return true;
+}
+
+bool STEPAnalyzer::CheckTopology(const TopoDS_Shape& shape, EntityInfo& info) {
+    // Count elements
+    CountElements(shape, info);
+    if (info.faceCount == 0) {
+        info.issues.push_back("Shape has no faces");
+        return false;
     }
 
+    // Check if closed
+    info.isClosed = CheckClosed(shape);
+
     // Check for small edges
     if (CheckSmallEdges(shape)) {
-        exportable = false;
         info.issues.push_back("Shape contains small edges");
+        return false;
+    }
+
+    // Check manifoldness
+    info.isManifold = CheckManifold(shape);
+    if (!info.isManifold) {
+        info.issues.push_back("Non-manifold shape");
     }
 
-    return exportable;
+    return true;
 }
 
 bool STEPAnalyzer::PerformMeshTest(const TopoDS_Shape& shape, EntityInfo& info) {
@@ -413,16 +817,104 @@ bool STEPAnalyzer::CheckClosed(const TopoDS_Shape& shape) {
     return !hasHoles;
 }
 
-double STEPAnalyzer::CalculateVolume(const TopoDS_Shape& shape) {
-    GProp_GProps props;
-    BRepGProp::VolumeProperties(shape, props);
-    return props.Mass();
-}
+void STEPAnalyzer::ComputeMassProperties(const TopoDS_Shape& shape, EntityInfo& info) {
+    // Per-face contributions, integrated in parallel and summed in face order
+    struct FaceMass {
+        double volume = 0.0;
+        double area = 0.0;
+        gp_XYZ volumeMoment;        // Integral of position over the volume contribution
+        gp_XYZ areaMoment;          // Integral of position over the area
+        double errorBound = 0.0;
+    };
+
+    // The explorer keeps the orientation each face has inside the shape, which
+    // the signed volume contributions rely on
+    std::vector<TopoDS_Face> faces;
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        faces.push_back(TopoDS::Face(exp.Current()));
+    }
+
+    const bool hasVolume = shape.ShapeType() == TopAbs_SOLID || shape.ShapeType() == TopAbs_COMPOUND
+        || shape.ShapeType() == TopAbs_COMPSOLID;
+    std::vector<FaceMass> masses(faces.size());
 
-double STEPAnalyzer::CalculateSurfaceArea(const TopoDS_Shape& shape) {
-    GProp_GProps props;
-    BRepGProp::SurfaceProperties(shape, props);
-    return props.Mass();
+    OSD_Parallel::For(0, static_cast<int>(faces.size()), [&](int i) {
+        const TopoDS_Face& face = faces[i];
+        FaceMass& mass = masses[i];
+
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) mesh;
+        if (m_fastMassProperties) {
+            mesh = BRep_Tool::Triangulation(face, location);
+        }
+
+        if (!mesh.IsNull()) {
+            // Divergence theorem over the triangles: each one spans a tetrahedron with the origin
+            const gp_Trsf& transform = location.Transformation();
+            const bool reversed = face.Orientation() == TopAbs_REVERSED;
+            for (int t = 1; t <= mesh->NbTriangles(); t++) {
+                int n1, n2, n3;
+                mesh->Triangle(t).Get(n1, n2, n3);
+                if (reversed) {
+                    std::swap(n2, n3);
+                }
+                gp_XYZ p1 = mesh->Node(n1).Transformed(transform).XYZ();
+                gp_XYZ p2 = mesh->Node(n2).Transformed(transform).XYZ();
+                gp_XYZ p3 = mesh->Node(n3).Transformed(transform).XYZ();
+
+                gp_XYZ cross = (p2 - p1).Crossed(p3 - p1);
+                double area = 0.5 * cross.Modulus();
+                double volume = p1.Dot(p2.Crossed(p3)) / 6.0;
+
+                mass.area += area;
+                mass.areaMoment += (p1 + p2 + p3) * (area / 3.0);
+                mass.volume += volume;
+                mass.volumeMoment += (p1 + p2 + p3) * (volume / 4.0);
+            }
+            // The mesh deviates from the surface by at most its deflection, so the
+            // enclosed volume can differ by at most area * deflection
+            mass.errorBound = mass.area * mesh->Deflection();
+        }
+        else {
+            GProp_GProps surfaceProps;
+            BRepGProp::SurfaceProperties(face, surfaceProps);
+            mass.area = surfaceProps.Mass();
+            mass.areaMoment = surfaceProps.CentreOfMass().XYZ() * mass.area;
+
+            if (hasVolume) {
+                GProp_GProps volumeProps;
+                BRepGProp::VolumeProperties(face, volumeProps);
+                mass.volume = volumeProps.Mass();
+                mass.volumeMoment = volumeProps.CentreOfMass().XYZ() * mass.volume;
+            }
+        }
+    });
+
+    double volume = 0.0;
+    double area = 0.0;
+    double errorBound = 0.0;
+    gp_XYZ volumeMoment;
+    gp_XYZ areaMoment;
+    for (const FaceMass& mass : masses) {
+        volume += mass.volume;
+        area += mass.area;
+        errorBound += mass.errorBound;
+        volumeMoment += mass.volumeMoment;
+        areaMoment += mass.areaMoment;
+    }
+
+    info.surfaceArea = area;
+    if (hasVolume) {
+        info.volume = volume;
+        info.volumeErrorBound = errorBound;
+    }
+
+    if (hasVolume && std::abs(volume) > Precision::Confusion()) {
+        info.centroid = gp_Pnt(volumeMoment / volume);
+    }
+    else if (area > Precision::Confusion()) {
+        info.centroid = gp_Pnt(areaMoment / area);
+    }
 }
 
 void STEPAnalyzer::CountElements(const TopoDS_Shape& shape, EntityInfo& info) {
@@ -466,22 +958,26 @@ bool STEPAnalyzer::HasValidGeometry(const TopoDS_Shape& shape) {
         if (box.IsVoid()) {
             return false;
         }
-        return true;
+        // A box collapsed to a point (or overflowing to infinity) means degenerate geometry
+        double extent = box.SquareExtent();
+        return extent > Precision::SquareConfusion() && !Precision::IsInfinite(extent);
     }
     catch (...) {
         return false;
     }
 }
 
-bool STEPAnalyzer::CheckSelfIntersection(const TopoDS_Shape& shape) {
+bool STEPAnalyzer::CheckSelfIntersection(const TopoDS_Shape& shape, EntityInfo& info) {
     try {
-        BRepExtrema_DistShapeShape extrema(shape, shape);
-        extrema.Perform();
-        
-        if (extrema.IsDone() && extrema.NbSolution() > 0) {
+        // Works on the triangulation left by the mesh test
+        TriangleIntersectionChecker checker;
+        if (checker.Load(shape) == 0) {
             return false;
         }
-        return false;
+
+        checker.Perform();
+        info.selfIntersectingFaces = checker.GetFacePairs();
+        return !info.selfIntersectingFaces.empty();
     }
     catch (...) {
         return true; // Assume self-intersection on exception
@@ -489,22 +985,24 @@ bool STEPAnalyzer::CheckSelfIntersection(const TopoDS_Shape& shape) {
 }
 
 bool STEPAnalyzer::CheckSmallEdges(const TopoDS_Shape& shape, double tolerance) {
-    TopExp_Explorer edgeExplorer(shape, TopAbs_EDGE);
-    bool hasSmallEdges = false;
-
-    while (edgeExplorer.More()) {
-        const TopoDS_Edge& edge = TopoDS::Edge(edgeExplorer.Current());
-        // Simplified edge length calculation
-        double length = 0.0;
-        // Note: EdgeLength method not found, using default value
+    TopTools_IndexedMapOfShape edgeMap;
+    TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
+
+    for (int i = 1; i <= edgeMap.Extent(); i++) {
+        const TopoDS_Edge& edge = TopoDS::Edge(edgeMap(i));
+        // Degenerated edges (e.g. sphere poles) have no 3D curve and are expected
+        if (BRep_Tool::Degenerated(edge) || !BRep_Tool::IsGeometric(edge)) {
+            continue;
+        }
+
+        BRepAdaptor_Curve curve(edge);
+        double length = GCPnts_AbscissaPoint::Length(curve);
         if (length < tolerance) {
-            hasSmallEdges = true;
-            break;
+            return true;
         }
-        edgeExplorer.Next();
     }
 
-    return hasSmallEdges;
+    return false;
 }
 
 TopoDS_Shape STEPAnalyzer::FixShape(const TopoDS_Shape& shape) {
@@ -1,4 +1,5 @@
 #include "STEPLoader.h"
+#include "ParallelStepTransfer.h"
 #include <IFSelect_ReturnStatus.hxx>
 #include <TopoDS_Shape.hxx>
 #include <TopExp_Explorer.hxx>
@@ -13,12 +14,22 @@
 #include <ShapeFix_Wire.hxx>
 #include <ShapeExtend_WireData.hxx>
 #include <TopoDS.hxx>
-#include <Interface_Static.hxx>
+#include <BRepBndLib.hxx>
+#include <Prs3d_Drawer.hxx>
+#include <StdPrs_ToolTriangulatedShape.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <TopTools_MapOfShape.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Face.hxx>
+#include <TopLoc_Location.hxx>
 
 STEPLoader::STEPLoader(QObject* parent)
     : QObject(parent),
-      m_enableFix(false)
+      m_enableFix(false),
+      m_parallelTransfer(false)
 {
+    m_readerOptions.maxPrecision = 0.01;
+    m_readerOptions.productMode = false;
 }
 
 bool STEPLoader::loadSTEPFile(const QString& filePath, bool enableFix)
@@ -26,16 +37,10 @@ bool STEPLoader::loadSTEPFile(const QString& filePath, bool enableFix)
     m_shapes.clear();
     m_enableFix = enableFix;
 
-    Interface_Static::SetIVal("read.step.brep.mode", 1);
-    Interface_Static::SetRVal("read.maxprecision.val", 0.01);
-    Interface_Static::SetIVal("read.step.product.mode", 0);
-    Interface_Static::SetCVal("read.surfacecurve.continuity", "C0");
-    Interface_Static::SetIVal("read.step.surfacecurve.mode", 1);
+    const std::string localFilePath = filePath.toLocal8Bit().toStdString();
 
-    const char* filePathCStr = filePath.toLocal8Bit().constData();
-
-    // read STEP file
-    IFSelect_ReturnStatus status = m_reader.ReadFile(filePathCStr);
+    // read STEP file with this loader's options (no global Interface_Static writes)
+    IFSelect_ReturnStatus status = m_readerOptions.ReadFile(m_reader, localFilePath);
 
     if (status != IFSelect_RetDone) {
         emit fileLoaded(false, "fail");
@@ -51,21 +56,20 @@ bool STEPLoader::loadSTEPFile(const QString& filePath, bool enableFix)
     // Set transfer mode to include all entity types (solids, curves, lines, etc.)
     //m_reader.SetTransferMode(STEPControl_AsIs);
     
-    // transfer roots to shapes
-    bool transferOk = m_reader.TransferRoots();
-    m_reader.PrintCheckTransfer(failsonly, IFSelect_ItemsByEntity);
+    // transfer roots to shapes (in root order, on worker threads if enabled)
+    ParallelStepTransfer transfer(m_reader);
+    transfer.SetParallel(m_parallelTransfer);
+    bool transferOk = transfer.Perform() > 0;
+    transfer.PrintCheckTransfer(failsonly, IFSelect_ItemsByEntity);
 
     if (!transferOk) {
         emit fileLoaded(false, "success");
         return false;
     }
 
-    // get number of shapes
-    int nbShapes = m_reader.NbShapes();
     int shapesLoaded = 0;
 
-    for (int i = 1; i <= nbShapes; i++) {
-        TopoDS_Shape shape = m_reader.Shape(i);
+    for (TopoDS_Shape shape : transfer.GetShapes()) {
         if (!shape.IsNull()) {
             // 如果启用了修复工具，修复形状
             if (m_enableFix) {
@@ -81,6 +85,103 @@ bool STEPLoader::loadSTEPFile(const QString& filePath, bool enableFix)
     return true;
 }
 
+bool STEPLoader::loadSTEPFileProgressive(const QString& filePath, const ProgressiveCallbacks& callbacks)
+{
+    m_shapes.clear();
+
+    const std::string localFilePath = filePath.toLocal8Bit().toStdString();
+
+    IFSelect_ReturnStatus status = m_readerOptions.ReadFile(m_reader, localFilePath);
+    if (status != IFSelect_RetDone) {
+        emit fileLoaded(false, "fail");
+        return false;
+    }
+
+    const Standard_Boolean failsonly = Standard_False;
+    const int rootCount = m_reader.NbRootsForTransfer();
+
+    // 在加载线程中按显示精度预先网格化，AIS显示时直接使用三角剖分
+    Handle(Prs3d_Drawer) drawer = new Prs3d_Drawer();
+
+    // 先报告包围盒作为占位，网格化后报告形状
+    auto presentRoot = [&](int rootIndex, TopoDS_Shape shape) {
+        if (shape.IsNull()) {
+            return;
+        }
+        if (m_enableFix) {
+            shape = fixShape(shape);
+        }
+
+        if (callbacks.rootTransferred) {
+            Bnd_Box box;
+            BRepBndLib::Add(shape, box);
+            if (!box.IsVoid()) {
+                callbacks.rootTransferred(rootIndex, rootCount, box);
+            }
+        }
+
+        meshUntriangulatedFaces(shape, drawer);
+        m_shapes.push_back(shape);
+
+        if (callbacks.rootReady) {
+            callbacks.rootReady(rootIndex, rootCount, shape);
+        }
+    };
+
+    if (m_parallelTransfer) {
+        // 并行转换一次性转换全部根实体（根实体太少或OCCT不支持时按顺序转换），
+        // 占位要等全部转换完成后才出现，换取更短的总转换时间
+        ParallelStepTransfer transfer(m_reader);
+        transfer.Perform();
+        transfer.PrintCheckTransfer(failsonly, IFSelect_ItemsByEntity);
+        const std::vector<TopoDS_Shape>& shapes = transfer.GetShapes();
+        for (int i = 1; i <= static_cast<int>(shapes.size()); i++) {
+            presentRoot(i, shapes[i - 1]);
+        }
+    }
+    else {
+        // 逐个转换根实体，而不是一次性TransferRoots，界面可以立即显示已完成的部分
+        for (int i = 1; i <= rootCount; i++) {
+            if (m_reader.TransferRoot(i)) {
+                presentRoot(i, m_reader.Shape(m_reader.NbShapes()));
+            }
+        }
+        m_reader.PrintCheckTransfer(failsonly, IFSelect_ItemsByEntity);
+    }
+
+    QString message = QString("success load %1 shapes").arg(m_shapes.size());
+    emit fileLoaded(!m_shapes.empty(), message);
+    return !m_shapes.empty();
+}
+
+void STEPLoader::meshUntriangulatedFaces(const TopoDS_Shape& shape, const Handle(Prs3d_Drawer)& drawer)
+{
+    // 根实体之间可能共享子零件的面：已网格化的面可能正由界面线程显示，不能重新网格化，
+    // 只对尚无三角剖分的面按本根实体的显示精度网格化（同一面的多个实例只网格化一次）
+    TopTools_MapOfShape pendingFaces;
+    TopoDS_Compound pending;
+    BRep_Builder builder;
+    builder.MakeCompound(pending);
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        TopLoc_Location location;
+        const TopoDS_Face& face = TopoDS::Face(exp.Current());
+        if (!BRep_Tool::Triangulation(face, location).IsNull()) {
+            continue;
+        }
+        TopoDS_Shape unlocated = face.Located(TopLoc_Location());
+        if (pendingFaces.Add(unlocated)) {
+            builder.Add(pending, unlocated);
+        }
+    }
+
+    if (pendingFaces.IsEmpty()) {
+        return;
+    }
+
+    const Standard_Real deflection = StdPrs_ToolTriangulatedShape::GetDeflection(shape, drawer);
+    BRepMesh_IncrementalMesh mesher(pending, deflection, Standard_False, drawer->DeviationAngle(), Standard_True);
+}
+
 TopoDS_Shape STEPLoader::fixShape(const TopoDS_Shape& shape)
 {
     // 复制原始形状
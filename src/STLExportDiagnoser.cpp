@@ -1,4 +1,7 @@
 #include "STLExportDiagnoser.h"
+#include "AnalysisRecordWriter.h"
+#include "MeshingWatchdog.h"
+#include "STLMultiLevelExporter.h"
 
 #include <STEPControl_Reader.hxx>
 #include <StlAPI_Writer.hxx>
@@ -16,10 +19,16 @@
 #include <TColStd_HSequenceOfTransient.hxx>
 #include <Interface_InterfaceModel.hxx>
 #include <Transfer_TransientProcess.hxx>
+#include <XSControl_TransferReader.hxx>
+#include <XSControl_WorkSession.hxx>
 #include <IFSelect_ReturnStatus.hxx>
 #include <iostream>
 
-STLExportDiagnoser::STLExportDiagnoser(double aDeflection) : myDeflection(aDeflection)
+STLExportDiagnoser::STLExportDiagnoser(double aDeflection)
+    : myDeflection(aDeflection)
+    , myTimeLimit(0.0)
+    , myMemoryLimit(0.0)
+    , myMeshAttemptCount(0)
 {
 }
 
@@ -43,6 +52,83 @@ bool STLExportDiagnoser::diagnoseStepFile(const std::string& filename, std::vect
     return true;
 }
 
+int STLExportDiagnoser::diagnoseShape(const TopoDS_Shape& aShape, AnalysisRecordWriter& writer)
+{
+    int index = 0;
+    int meshableCount = 0;
+    
+    diagnoseAndMeshShapes(aShape, [&](MeshDiagnosis&& diag) {
+        writeDiagnosisRecord(writer, diag, ++index, 0);
+        if (diag.isMeshable) {
+            meshableCount++;
+        }
+    });
+    
+    writer.beginRecord("summary");
+    writer.field("analyzer", "STLExportDiagnoser");
+    writer.field("deflection", myDeflection);
+    writer.field("entities", index);
+    writer.field("exportable", meshableCount);
+    writer.field("nonExportable", index - meshableCount);
+    writer.endRecord();
+    writer.flush();
+    
+    return meshableCount;
+}
+
+bool STLExportDiagnoser::diagnoseStepFile(const std::string& filename, AnalysisRecordWriter& writer)
+{
+    STEPControl_Reader reader;
+    IFSelect_ReturnStatus status = reader.ReadFile(filename.c_str());
+    
+    if (status != IFSelect_RetDone) {
+        std::cerr << "无法读取STEP文件" << std::endl;
+        return false;
+    }
+    
+    int rootCount = reader.NbRootsForTransfer();
+    int index = 0;
+    int meshableCount = 0;
+    
+    // 逐个转换根实体，诊断完成后立即清除，峰值内存只取决于单个根实体
+    for (int i = 1; i <= rootCount; i++) {
+        if (reader.TransferRoot(i)) {
+            TopoDS_Shape shape = reader.Shape(reader.NbShapes());
+            if (!shape.IsNull()) {
+                diagnoseAndMeshShapes(shape, [&](MeshDiagnosis&& diag) {
+                    writeDiagnosisRecord(writer, diag, ++index, i);
+                    if (diag.isMeshable) {
+                        meshableCount++;
+                    }
+                });
+            }
+        }
+        
+        // 转换结果同时记录在形状列表、TransferReader的结果表和TransientProcess中，
+        // 三者都清除后该根实体才真正释放（Clear(1)只清结果，保留模型供后续根实体使用）
+        reader.ClearShapes();
+        const Handle(XSControl_TransferReader)& transferReader = reader.WS()->TransferReader();
+        transferReader->Clear(1);
+        Handle(Transfer_TransientProcess) transferProcess = transferReader->TransientProcess();
+        if (!transferProcess.IsNull()) {
+            transferProcess->Clear();
+        }
+    }
+    
+    writer.beginRecord("summary");
+    writer.field("analyzer", "STLExportDiagnoser");
+    writer.field("file", filename);
+    writer.field("deflection", myDeflection);
+    writer.field("roots", rootCount);
+    writer.field("entities", index);
+    writer.field("exportable", meshableCount);
+    writer.field("nonExportable", index - meshableCount);
+    writer.endRecord();
+    writer.flush();
+    
+    return true;
+}
+
 std::vector<TopoDS_Shape> STLExportDiagnoser::getExportableShapes(const std::vector<MeshDiagnosis>& diagnoses) const 
 {
     std::vector<TopoDS_Shape> exportable;
@@ -159,8 +245,23 @@ double STLExportDiagnoser::getDeflection() const
     return myDeflection;
 }
 
+void STLExportDiagnoser::setTimeLimit(double seconds)
+{
+    myTimeLimit = seconds;
+}
+
+void STLExportDiagnoser::setMemoryLimit(double megabytes)
+{
+    myMemoryLimit = megabytes;
+}
+
+int STLExportDiagnoser::getMeshAttemptCount() const
+{
+    return myMeshAttemptCount;
+}
+
 // 递归分解形状的辅助函数
-void STLExportDiagnoser::recursiveDiagnose(const TopoDS_Shape& aShape, std::vector<MeshDiagnosis>& results) {
+void STLExportDiagnoser::recursiveDiagnose(const TopoDS_Shape& aShape, const DiagnosisSink& sink, int& count) {
     // 获取当前形状类型
     TopAbs_ShapeEnum shapeType = aShape.ShapeType();
     
@@ -172,13 +273,14 @@ void STLExportDiagnoser::recursiveDiagnose(const TopoDS_Shape& aShape, std::vect
     
     // 如果是可诊断的形状，直接进行诊断
     if (isDiagnosable) {
-        results.push_back(diagnoseSingleEntity(aShape));
+        sink(diagnoseSingleEntity(aShape));
+        count++;
     } else {
         // 否则递归分解复合形状
         TopoDS_Iterator it(aShape);
         for (; it.More(); it.Next()) {
             const TopoDS_Shape& subShape = it.Value();
-            recursiveDiagnose(subShape, results);
+            recursiveDiagnose(subShape, sink, count);
         }
     }
 }
@@ -187,16 +289,46 @@ std::vector<MeshDiagnosis> STLExportDiagnoser::diagnoseAndMeshShapes(const TopoD
 { 
     std::vector<MeshDiagnosis> results; 
     
+    diagnoseAndMeshShapes(aShape, [&results](MeshDiagnosis&& diag) {
+        results.push_back(std::move(diag));
+    });
+    
+    return results; 
+}
+
+int STLExportDiagnoser::diagnoseAndMeshShapes(const TopoDS_Shape& aShape, const DiagnosisSink& sink)
+{
+    int count = 0;
+    
     // 递归分解并诊断所有形状
-    recursiveDiagnose(aShape, results);
+    recursiveDiagnose(aShape, sink, count);
     
     // 如果递归分解后没有结果，说明形状可能是基本类型（如WIRE、EDGE、VERTEX）
     // 或者是空形状，此时直接诊断原始形状
-    if (results.empty()) {
-        results.push_back(diagnoseSingleEntity(aShape));
+    if (count == 0) {
+        sink(diagnoseSingleEntity(aShape));
+        count++;
     }
     
-    return results; 
+    return count;
+}
+
+void STLExportDiagnoser::writeDiagnosisRecord(AnalysisRecordWriter& writer, const MeshDiagnosis& diag, int index, int rootIndex) const
+{
+    writer.beginRecord("shape");
+    writer.field("analyzer", "STLExportDiagnoser");
+    writer.field("index", index);
+    if (rootIndex > 0) {
+        writer.field("root", rootIndex);
+    }
+    writer.field("shapeType", diag.shape.IsNull() ? std::string("NULL") : shapeTypeToString(diag.shape.ShapeType()));
+    writer.field("meshable", diag.isMeshable);
+    if (!diag.isMeshable) {
+        writer.field("reason", diag.failureReason);
+    }
+    writer.field("faces", diag.faceCount);
+    writer.field("triangulatedFaces", diag.triangulatedFaceCount);
+    writer.endRecord();
 }
 
 bool STLExportDiagnoser::readStepAsSeparateShapes(const std::string& filename, std::vector<TopoDS_Shape>& outShapes) const
@@ -245,8 +377,26 @@ MeshDiagnosis STLExportDiagnoser::diagnoseSingleEntity(const TopoDS_Shape& shape
     diag.triangulatedFaceCount = 0;
     
     try {
-        // 尝试对当前独立实体进行网格化
-        BRepMesh_IncrementalMesh mesher(shape, myDeflection, false, 0.5, true);
+        // 尝试对当前独立实体进行网格化（受时间/内存预算约束）
+        IMeshTools_Parameters params;
+        params.Deflection = myDeflection;
+        params.Angle = 0.5;
+        params.Relative = Standard_False;
+        params.InParallel = Standard_True;
+        
+        Handle(MeshingWatchdog) watchdog = new MeshingWatchdog(myTimeLimit, myMemoryLimit);
+        myMeshAttemptCount++;
+        watchdog->Mesh(shape, params);
+        
+        if (watchdog->IsBudgetExceeded()) {
+            // 清除被中断的网格化留下的部分三角化结果
+            BRepTools::Clean(shape);
+            for (TopExp_Explorer faceExplorer(shape, TopAbs_FACE); faceExplorer.More(); faceExplorer.Next()) {
+                diag.faceCount++;
+            }
+            diag.failureReason = "网格化超时: " + watchdog->GetStatusDescription();
+            return diag;
+        }
         
         // 诊断：检查该实体中实际有多少个面被成功三角化
         for (TopExp_Explorer faceExplorer(shape, TopAbs_FACE);
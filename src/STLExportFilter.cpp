@@ -1,4 +1,5 @@
 #include "STLExportFilter.h"
+#include "MeshingWatchdog.h"
 
 // OCCT Includes
 #include <BRepMesh_IncrementalMesh.hxx>
@@ -10,15 +11,19 @@
 #include <TopoDS_Edge.hxx>
 #include <TopoDS_Vertex.hxx>
 #include <BRep_Builder.hxx>
+#include <BRepTools.hxx>
 #include <StlAPI_Writer.hxx>
 #include <Precision.hxx>
 #include <TopAbs.hxx>
 
 // Standard Includes
+#include <algorithm>
 #include <iostream>
 
 STLExportFilter::STLExportFilter(double deflection)
     : deflection_(deflection)
+    , releaseTriangulation_(false)
+    , meshAttemptCount_(0)
 {
 }
 
@@ -34,6 +39,8 @@ bool STLExportFilter::separate(const TopoDS_Shape& inputShape,
     BRep_Builder builder;
     builder.MakeCompound(exportableParts);
     builder.MakeCompound(nonExportableParts);
+    meshAttemptCount_ = 0;
+    memoryCeiling_.Reset();
 
     // Process shape recursively
     processShapeRecursive(inputShape, exportableParts, nonExportableParts);
@@ -46,6 +53,26 @@ void STLExportFilter::setDeflection(double deflection)
     deflection_ = deflection;
 }
 
+void STLExportFilter::setReleaseTriangulation(bool release)
+{
+    releaseTriangulation_ = release;
+}
+
+void STLExportFilter::setMemoryCeiling(double megabytes)
+{
+    memoryCeiling_.SetCeiling(megabytes);
+}
+
+int STLExportFilter::getForcedReleaseCount() const
+{
+    return memoryCeiling_.GetForcedReleaseCount();
+}
+
+int STLExportFilter::getMeshAttemptCount() const
+{
+    return meshAttemptCount_;
+}
+
 bool STLExportFilter::isExportableToSTL(const TopoDS_Shape& shape)
 {
     // Skip empty shapes
@@ -72,6 +99,7 @@ bool STLExportFilter::createMesh(const TopoDS_Shape& shape)
 {
     try {
         // Create mesh using BRepMesh_IncrementalMesh
+        meshAttemptCount_++;
         BRepMesh_IncrementalMesh meshBuilder(shape, deflection_);
         meshBuilder.Perform();
 
@@ -119,6 +147,7 @@ void STLExportFilter::processShapeRecursive(const TopoDS_Shape& shape,
         // Add to exportable parts if it can be exported
         BRep_Builder builder;
         builder.Add(exportableParts, shape);
+        releaseTriangulation(shape);
         return;
     }
     
@@ -173,5 +202,17 @@ void STLExportFilter::processShapeRecursive(const TopoDS_Shape& shape,
         // Can't decompose further, add to non-exportable parts
         BRep_Builder builder;
         builder.Add(nonExportableParts, shape);
+        releaseTriangulation(shape);
     }
 }
+
+void STLExportFilter::releaseTriangulation(const TopoDS_Shape& shape)
+{
+    if (releaseTriangulation_) {
+        // Only the classification is needed - drop the probing mesh right away
+        BRepTools::Clean(shape);
+        return;
+    }
+
+    memoryCeiling_.Add(shape);
+}
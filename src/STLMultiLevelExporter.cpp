@@ -1,4 +1,5 @@
 #include "STLMultiLevelExporter.h"
+#include "AnalysisRecordWriter.h"
 
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <StlAPI_Writer.hxx>
@@ -15,49 +16,56 @@
 #include <sstream>
 #include <fstream>
 
-// 辅助函数声明：将TopAbs_ShapeEnum转换为字符串
-std::string shapeTypeToString(TopAbs_ShapeEnum shapeType);
-
 // 静态常量定义
 const double STLMultiLevelExporter::TRIANGULATION_COVERAGE_THRESHOLD = 0.8;
 
-STLMultiLevelExporter::STLMultiLevelExporter(double deflection) : m_deflection(deflection) {
+STLMultiLevelExporter::STLMultiLevelExporter(double deflection)
+    : m_deflection(deflection)
+    , m_successCount(0)
+    , m_failureCount(0)
+    , m_meshAttemptCount(0)
+    , m_keepResults(true)
+    , m_strategy(DecompositionStrategy::TOP_DOWN)
+    , m_recordWriter(nullptr) {
 }
 
 bool STLMultiLevelExporter::exportToSTL(const TopoDS_Shape& inputShape, const std::string& filename) {
-    // 分解并分析模型
-    std::vector<ExportResult> results = decomposeAndAnalyze(inputShape);
-    
-    // 收集可导出的形状
-    std::vector<TopoDS_Shape> exportableShapes;
-    for (const auto& result : results) {
-        if (result.exportedSuccessfully) {
-            exportableShapes.push_back(result.shape);
-        }
-    }
+    // 分解并分析模型（可导出的形状在分解过程中收集到m_exportableParts）
+    decomposeAndAnalyze(inputShape);
     
-    if (exportableShapes.empty()) {
+    if (m_successCount == 0) {
         return false;
     }
     
-    // 将可导出的形状合并为一个复合形状
-    BRep_Builder builder;
-    TopoDS_Compound resultCompound;
-    builder.MakeCompound(resultCompound);
-    
-    for (const auto& shape : exportableShapes) {
-        builder.Add(resultCompound, shape);
-    }
-    
     // 导出到STL
     StlAPI_Writer stlWriter;
     stlWriter.ASCIIMode() = false;
-    return stlWriter.Write(resultCompound, filename.c_str());
+    return stlWriter.Write(m_exportableParts, filename.c_str());
 }
 
 std::vector<ExportResult> STLMultiLevelExporter::decomposeAndAnalyze(const TopoDS_Shape& inputShape) {
     m_exportResults.clear();
+    m_successCount = 0;
+    m_failureCount = 0;
+    m_meshAttemptCount = 0;
+    
+    BRep_Builder builder;
+    builder.MakeCompound(m_exportableParts);
+    
     decomposeShape(inputShape, "ROOT", m_exportResults);
+    
+    if (m_recordWriter != nullptr) {
+        m_recordWriter->beginRecord("summary");
+        m_recordWriter->field("analyzer", "STLMultiLevelExporter");
+        m_recordWriter->field("deflection", m_deflection);
+        m_recordWriter->field("shapes", m_successCount + m_failureCount);
+        m_recordWriter->field("exported", m_successCount);
+        m_recordWriter->field("failed", m_failureCount);
+        m_recordWriter->field("meshAttempts", m_meshAttemptCount);
+        m_recordWriter->endRecord();
+        m_recordWriter->flush();
+    }
+    
     return m_exportResults;
 }
 
@@ -71,40 +79,146 @@ void STLMultiLevelExporter::decomposeShape(const TopoDS_Shape& shape, const std:
     
     // 尝试导出当前形状
     bool exported = tryExportShape(shape, result);
-    results.push_back(result);
+    recordResult(result, results);
     
     // 如果当前形状导出失败，尝试分解为更低级别的形状
+    // （只有网格化完成后才会统计面数，faceCount > 0 即网格化完成但覆盖率不足）
     if (!exported) {
-        TopAbs_ShapeEnum shapeType = shape.ShapeType();
+        decomposeChildren(shape, result.faceCount > 0, results);
+    }
+}
+
+void STLMultiLevelExporter::decomposeChildren(const TopoDS_Shape& shape, bool meshed, std::vector<ExportResult>& results) {
+    std::vector<TopoDS_Shape> children;
+    std::string childLevel;
+    if (!getChildShapes(shape, children, childLevel)) {
+        return;
+    }
+    
+    if (m_strategy == DecompositionStrategy::BISECTION && children.size() > 1) {
+        if (meshed) {
+            // 父形状已网格化完成，子形状的三角化已在面上，直接按覆盖率分类
+            classifyMeshedShapes(children, 0, children.size(), childLevel, results);
+        } else {
+            // 父形状整体网格化失败，对同一组面再网格化一次没有意义，直接从两半开始
+            size_t middle = children.size() / 2;
+            bisectShapes(children, 0, middle, childLevel, results);
+            bisectShapes(children, middle, children.size(), childLevel, results);
+        }
+    } else {
+        for (const auto& child : children) {
+            decomposeShape(child, childLevel, results);
+        }
+    }
+}
+
+bool STLMultiLevelExporter::getChildShapes(const TopoDS_Shape& shape, std::vector<TopoDS_Shape>& children, std::string& childLevel) const {
+    TopAbs_ShapeEnum childType;
+    
+    switch (shape.ShapeType()) {
+    case TopAbs_COMPOUND:
+    case TopAbs_COMPSOLID:
+        // 分解为SOLID级别
+        childType = TopAbs_SOLID;
+        childLevel = "SOLID";
+        break;
+    case TopAbs_SOLID:
+        // 分解为SHELL级别
+        childType = TopAbs_SHELL;
+        childLevel = "SHELL";
+        break;
+    case TopAbs_SHELL:
+        // 分解为FACE级别
+        childType = TopAbs_FACE;
+        childLevel = "FACE";
+        break;
+    default:
+        // WIRE、EDGE、VERTEX等形状类型不能单独导出到STL
+        return false;
+    }
+    
+    for (TopExp_Explorer explorer(shape, childType); explorer.More(); explorer.Next()) {
+        children.push_back(explorer.Current());
+    }
+    return !children.empty();
+}
+
+void STLMultiLevelExporter::bisectShapes(const std::vector<TopoDS_Shape>& shapes, size_t first, size_t last,
+                                         const std::string& level, std::vector<ExportResult>& results) {
+    if (last - first == 1) {
+        // 只剩一个子形状：按常规方式单独尝试并继续向下分解
+        decomposeShape(shapes[first], level, results);
+        return;
+    }
+    
+    if (!meshGroup(shapes, first, last)) {
+        // 整体网格化失败（异常或未完成），无法判断是哪一部分导致，二分后分别尝试
+        size_t middle = first + (last - first) / 2;
+        bisectShapes(shapes, first, middle, level, results);
+        bisectShapes(shapes, middle, last, level, results);
+        return;
+    }
+    
+    classifyMeshedShapes(shapes, first, last, level, results);
+}
+
+void STLMultiLevelExporter::classifyMeshedShapes(const std::vector<TopoDS_Shape>& shapes, size_t first, size_t last,
+                                                 const std::string& level, std::vector<ExportResult>& results) {
+    // 网格化完成：三角化已附着在各个面上，逐个子形状统计覆盖率即可，无需重新网格化
+    for (size_t i = first; i < last; i++) {
+        ExportResult result;
+        result.shape = shapes[i];
+        result.shapeLevel = level;
+        result.exportedSuccessfully = false;
         
-        switch (shapeType) {
-        case TopAbs_COMPOUND:
-        case TopAbs_COMPSOLID:
-            // 分解为SOLID级别
-            for (TopExp_Explorer explorer(shape, TopAbs_SOLID); explorer.More(); explorer.Next()) {
-                decomposeShape(explorer.Current(), "SOLID", results);
-            }
-            break;
-        case TopAbs_SOLID:
-            // 分解为SHELL级别
-            for (TopExp_Explorer explorer(shape, TopAbs_SHELL); explorer.More(); explorer.Next()) {
-                decomposeShape(explorer.Current(), "SHELL", results);
-            }
-            break;
-        case TopAbs_SHELL:
-            // 分解为FACE级别
-            for (TopExp_Explorer explorer(shape, TopAbs_FACE); explorer.More(); explorer.Next()) {
-                decomposeShape(explorer.Current(), "FACE", results);
-            }
-            break;
-        case TopAbs_WIRE:
-        case TopAbs_EDGE:
-        case TopAbs_VERTEX:
-            // 这些形状类型不能单独导出到STL
-            break;
-        default:
-            break;
+        double coverage = calculateTriangulationCoverage(shapes[i], result);
+        if (coverage >= TRIANGULATION_COVERAGE_THRESHOLD) {
+            result.exportedSuccessfully = true;
+        } else {
+            result.failureReason = "Triangulation coverage too low";
         }
+        recordResult(result, results);
+        
+        // 覆盖率不足的子形状继续分解；它已网格化完成，其子形状同样直接按覆盖率分类
+        if (!result.exportedSuccessfully) {
+            decomposeChildren(shapes[i], true, results);
+        }
+    }
+}
+
+bool STLMultiLevelExporter::meshGroup(const std::vector<TopoDS_Shape>& shapes, size_t first, size_t last) {
+    BRep_Builder builder;
+    TopoDS_Compound group;
+    builder.MakeCompound(group);
+    for (size_t i = first; i < last; i++) {
+        builder.Add(group, shapes[i]);
+    }
+    
+    m_meshAttemptCount++;
+    try {
+        BRepMesh_IncrementalMesh mesher(group, m_deflection, false, 0.5, true);
+        return mesher.IsDone();
+    } catch (...) {
+        return false;
+    }
+}
+
+void STLMultiLevelExporter::recordResult(const ExportResult& result, std::vector<ExportResult>& results) {
+    if (result.exportedSuccessfully) {
+        BRep_Builder builder;
+        builder.Add(m_exportableParts, result.shape);
+        m_successCount++;
+    } else {
+        m_failureCount++;
+    }
+    
+    // 形状分类后立即输出记录
+    if (m_recordWriter != nullptr) {
+        writeResultRecord(result, m_successCount + m_failureCount);
+    }
+    
+    if (m_keepResults) {
+        results.push_back(result);
     }
 }
 
@@ -130,6 +244,7 @@ bool STLMultiLevelExporter::tryExportShape(const TopoDS_Shape& shape, ExportResu
     
     try {
         // 尝试对形状进行网格化
+        m_meshAttemptCount++;
         BRepMesh_IncrementalMesh mesher(shape, m_deflection, false, 0.5, true);
         mesher.Perform();
         
@@ -139,7 +254,7 @@ bool STLMultiLevelExporter::tryExportShape(const TopoDS_Shape& shape, ExportResu
         }
         
         // 计算三角化覆盖率
-        double coverage = calculateTriangulationCoverage(shape);
+        double coverage = calculateTriangulationCoverage(shape, result);
         
         // 检查覆盖率是否达到阈值
         if (coverage >= TRIANGULATION_COVERAGE_THRESHOLD) {
@@ -168,7 +283,8 @@ bool STLMultiLevelExporter::isTriangulable(const TopoDS_Shape& shape) {
             return false;
         }
         
-        double coverage = calculateTriangulationCoverage(shape);
+        ExportResult result;
+        double coverage = calculateTriangulationCoverage(shape, result);
         return coverage >= TRIANGULATION_COVERAGE_THRESHOLD;
         
     } catch (...) {
@@ -176,7 +292,7 @@ bool STLMultiLevelExporter::isTriangulable(const TopoDS_Shape& shape) {
     }
 }
 
-double STLMultiLevelExporter::calculateTriangulationCoverage(const TopoDS_Shape& shape) {
+double STLMultiLevelExporter::calculateTriangulationCoverage(const TopoDS_Shape& shape, ExportResult& result) {
     int faceCount = 0;
     int triangulatedFaceCount = 0;
     
@@ -195,9 +311,8 @@ double STLMultiLevelExporter::calculateTriangulationCoverage(const TopoDS_Shape&
     }
     
     // 更新结果对象中的面计数
-    ExportResult* result = &m_exportResults.back();
-    result->faceCount = faceCount;
-    result->triangulatedFaceCount = triangulatedFaceCount;
+    result.faceCount = faceCount;
+    result.triangulatedFaceCount = triangulatedFaceCount;
     
     if (faceCount == 0) {
         return 0.0;
@@ -223,9 +338,11 @@ std::string STLMultiLevelExporter::generateReport() const {
     
     report << "=== STL Multi-Level Export Report ===\n";
     report << "Deflection: " << m_deflection << "\n";
-    report << "Total shapes processed: " << m_exportResults.size() << "\n";
+    report << "Total shapes processed: " << getTotalShapeCount() << "\n";
     report << "Successfully exported: " << getSuccessCount() << "\n";
-    report << "Failed to export: " << getFailureCount() << "\n\n";
+    report << "Failed to export: " << getFailureCount() << "\n";
+    report << "Decomposition: " << (m_strategy == DecompositionStrategy::BISECTION ? "bisection" : "top-down") << "\n";
+    report << "Mesh attempts: " << m_meshAttemptCount << "\n\n";
     
     int successCounter = 0;
     int failureCounter = 0;
@@ -254,27 +371,50 @@ std::string STLMultiLevelExporter::generateReport() const {
 }
 
 int STLMultiLevelExporter::getSuccessCount() const {
-    int count = 0;
-    for (const auto& result : m_exportResults) {
-        if (result.exportedSuccessfully) {
-            count++;
-        }
-    }
-    return count;
+    return m_successCount;
 }
 
 int STLMultiLevelExporter::getFailureCount() const {
-    int count = 0;
-    for (const auto& result : m_exportResults) {
-        if (!result.exportedSuccessfully) {
-            count++;
-        }
-    }
-    return count;
+    return m_failureCount;
 }
 
 int STLMultiLevelExporter::getTotalShapeCount() const {
-    return m_exportResults.size();
+    return m_successCount + m_failureCount;
+}
+
+void STLMultiLevelExporter::setRecordWriter(AnalysisRecordWriter* writer) {
+    m_recordWriter = writer;
+}
+
+void STLMultiLevelExporter::setKeepResults(bool keep) {
+    m_keepResults = keep;
+}
+
+void STLMultiLevelExporter::setDecompositionStrategy(DecompositionStrategy strategy) {
+    m_strategy = strategy;
+}
+
+DecompositionStrategy STLMultiLevelExporter::getDecompositionStrategy() const {
+    return m_strategy;
+}
+
+int STLMultiLevelExporter::getMeshAttemptCount() const {
+    return m_meshAttemptCount;
+}
+
+void STLMultiLevelExporter::writeResultRecord(const ExportResult& result, int index) {
+    m_recordWriter->beginRecord("shape");
+    m_recordWriter->field("analyzer", "STLMultiLevelExporter");
+    m_recordWriter->field("index", index);
+    m_recordWriter->field("level", result.shapeLevel);
+    m_recordWriter->field("shapeType", result.shape.IsNull() ? std::string("NULL") : shapeTypeToString(result.shape.ShapeType()));
+    m_recordWriter->field("exported", result.exportedSuccessfully);
+    if (!result.exportedSuccessfully) {
+        m_recordWriter->field("reason", result.failureReason);
+    }
+    m_recordWriter->field("faces", result.faceCount);
+    m_recordWriter->field("triangulatedFaces", result.triangulatedFaceCount);
+    m_recordWriter->endRecord();
 }
 
 // 辅助函数：将TopAbs_ShapeEnum转换为字符串
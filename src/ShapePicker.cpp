@@ -0,0 +1,466 @@
+#include "ShapePicker.h"
+#include "ViewTool.h"
+
+#include <BRep_Tool.hxx>
+#include <Poly_Polygon3D.hxx>
+#include <Poly_PolygonOnTriangulation.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TColStd_Array1OfInteger.hxx>
+#include <TColgp_Array1OfPnt.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopoDS.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+    // Maximum number of triangles in a leaf
+    const int LEAF_SIZE = 4;
+
+    // Relative margin of the ray/triangle test, so that rays along shared edges still hit
+    const double PARAM_EPSILON = 1.0e-7;
+
+    // Squared distance between a ray and a segment, with the ray parameter of the closest point
+    double raySegmentDistance(const gp_Lin& ray, const gp_Pnt& a, const gp_Pnt& b, double& rayParameter)
+    {
+        const gp_XYZ origin = ray.Location().XYZ();
+        const gp_XYZ d = ray.Direction().XYZ();
+        const gp_XYZ e = b.XYZ() - a.XYZ();
+        const gp_XYZ w = origin - a.XYZ();
+
+        const double ee = e.Dot(e);
+        const double de = d.Dot(e);
+        const double dw = d.Dot(w);
+        const double ew = e.Dot(w);
+
+        // Closest points of the two lines, the segment parameter clamped to [0, 1]
+        double s = 0.0;
+        const double denominator = ee - de * de;
+        if (ee > 0.0) {
+            s = denominator > 1.0e-12 * ee ? (ew - de * dw) / denominator : ew / ee;
+            s = std::min(1.0, std::max(0.0, s));
+        }
+        const gp_XYZ onSegment = a.XYZ() + e * s;
+        rayParameter = d.Dot(onSegment - origin);
+        const gp_XYZ onRay = origin + d * rayParameter;
+        return (onSegment - onRay).SquareModulus();
+    }
+}
+
+ShapePicker::ShapePicker()
+{
+}
+
+void ShapePicker::clear()
+{
+    m_vertices.clear();
+    m_triangleFaces.clear();
+    m_boxes.clear();
+    m_order.clear();
+    m_nodes.clear();
+    m_faces.Clear();
+    m_edges.Clear();
+    m_faceEdges.clear();
+    m_freeEdges.clear();
+    m_edgePoints.clear();
+}
+
+int ShapePicker::build(const TopoDS_Shape& shape)
+{
+    clear();
+    if (shape.IsNull()) {
+        return 0;
+    }
+
+    // Every occurrence of a face is a separate entry, with its location applied to the nodes
+    for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(exp.Current());
+        if (m_faces.Contains(face)) {
+            continue;
+        }
+
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(face, location);
+        const int faceIndex = m_faces.Add(face);
+        m_faceEdges.resize(faceIndex);
+        if (mesh.IsNull()) {
+            continue;
+        }
+
+        const gp_Trsf& transform = location.Transformation();
+        const bool identity = location.IsIdentity();
+        std::vector<gp_Pnt> nodes(mesh->NbNodes());
+        for (int i = 1; i <= mesh->NbNodes(); i++) {
+            nodes[i - 1] = mesh->Node(i);
+            if (!identity) {
+                nodes[i - 1].Transform(transform);
+            }
+        }
+
+        for (int t = 1; t <= mesh->NbTriangles(); t++) {
+            int n[3];
+            mesh->Triangle(t).Get(n[0], n[1], n[2]);
+            for (int k = 0; k < 3; k++) {
+                const gp_Pnt& node = nodes[n[k] - 1];
+                m_vertices.push_back(static_cast<float>(node.X()));
+                m_vertices.push_back(static_cast<float>(node.Y()));
+                m_vertices.push_back(static_cast<float>(node.Z()));
+            }
+            m_triangleFaces.push_back(faceIndex);
+        }
+
+        // Edge polylines index the nodes of this face's triangulation
+        std::vector<EdgePolyline>& faceEdges = m_faceEdges[faceIndex - 1];
+        for (TopExp_Explorer edgeExp(face, TopAbs_EDGE); edgeExp.More(); edgeExp.Next()) {
+            const TopoDS_Edge& edge = TopoDS::Edge(edgeExp.Current());
+            Handle(Poly_PolygonOnTriangulation) polygon = BRep_Tool::PolygonOnTriangulation(edge, mesh, location);
+            if (polygon.IsNull() || polygon->NbNodes() < 2) {
+                continue;
+            }
+
+            EdgePolyline polyline;
+            polyline.edge = m_edges.Add(edge);
+            polyline.first = static_cast<int>(m_edgePoints.size());
+            polyline.count = polygon->NbNodes();
+            const TColStd_Array1OfInteger& indices = polygon->Nodes();
+            for (int i = indices.Lower(); i <= indices.Upper(); i++) {
+                m_edgePoints.push_back(nodes[indices(i) - 1]);
+            }
+            faceEdges.push_back(polyline);
+        }
+    }
+
+    // Edges without faces take the 3D polygon they are drawn with
+    TopTools_IndexedDataMapOfShapeListOfShape edgeFaces;
+    TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, edgeFaces);
+    for (int i = 1; i <= edgeFaces.Extent(); i++) {
+        if (!edgeFaces(i).IsEmpty()) {
+            continue;
+        }
+
+        const TopoDS_Edge& edge = TopoDS::Edge(edgeFaces.FindKey(i));
+        TopLoc_Location location;
+        Handle(Poly_Polygon3D) polygon = ViewTool::polygonOfEdge(edge, location);
+        if (polygon.IsNull() || polygon->NbNodes() < 2) {
+            continue;
+        }
+
+        EdgePolyline polyline;
+        polyline.edge = m_edges.Add(edge);
+        polyline.first = static_cast<int>(m_edgePoints.size());
+        polyline.count = polygon->NbNodes();
+        const TColgp_Array1OfPnt& nodes = polygon->Nodes();
+        for (int j = nodes.Lower(); j <= nodes.Upper(); j++) {
+            m_edgePoints.push_back(location.IsIdentity() ? nodes(j) : nodes(j).Transformed(location.Transformation()));
+        }
+        m_freeEdges.push_back(polyline);
+    }
+
+    const int triangleCount = static_cast<int>(m_triangleFaces.size());
+    if (triangleCount == 0) {
+        return 0;
+    }
+
+    m_boxes.resize(static_cast<size_t>(triangleCount) * 6);
+    for (int i = 0; i < triangleCount; i++) {
+        const float* v = &m_vertices[static_cast<size_t>(i) * 9];
+        float* box = &m_boxes[static_cast<size_t>(i) * 6];
+        for (int axis = 0; axis < 3; axis++) {
+            box[axis] = std::min(v[axis], std::min(v[axis + 3], v[axis + 6]));
+            box[axis + 3] = std::max(v[axis], std::max(v[axis + 3], v[axis + 6]));
+        }
+    }
+
+    m_order.resize(triangleCount);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    m_nodes.reserve(2 * (triangleCount / LEAF_SIZE + 1));
+    buildNode(0, triangleCount);
+
+    // The boxes are only needed to split the nodes
+    m_boxes.clear();
+    m_boxes.shrink_to_fit();
+
+    return triangleCount;
+}
+
+int ShapePicker::buildNode(int begin, int end)
+{
+    const int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(BvhNode());
+
+    const float infinity = std::numeric_limits<float>::max();
+    float boxMin[3] = { infinity, infinity, infinity };
+    float boxMax[3] = { -infinity, -infinity, -infinity };
+    float centerMin[3] = { infinity, infinity, infinity };
+    float centerMax[3] = { -infinity, -infinity, -infinity };
+    for (int i = begin; i < end; i++) {
+        const float* box = &m_boxes[static_cast<size_t>(m_order[i]) * 6];
+        for (int axis = 0; axis < 3; axis++) {
+            boxMin[axis] = std::min(boxMin[axis], box[axis]);
+            boxMax[axis] = std::max(boxMax[axis], box[axis + 3]);
+            float center = box[axis] + box[axis + 3];
+            centerMin[axis] = std::min(centerMin[axis], center);
+            centerMax[axis] = std::max(centerMax[axis], center);
+        }
+    }
+
+    BvhNode node;
+    std::copy(boxMin, boxMin + 3, node.boxMin);
+    std::copy(boxMax, boxMax + 3, node.boxMax);
+    node.left = -1;
+    node.right = -1;
+    node.first = begin;
+    node.count = end - begin;
+
+    if (end - begin > LEAF_SIZE) {
+        // Median split along the longest axis of the centroid bounds
+        int axis = 0;
+        for (int a = 1; a < 3; a++) {
+            if (centerMax[a] - centerMin[a] > centerMax[axis] - centerMin[axis]) {
+                axis = a;
+            }
+        }
+
+        if (centerMax[axis] > centerMin[axis]) {
+            const int middle = begin + (end - begin) / 2;
+            std::nth_element(m_order.begin() + begin, m_order.begin() + middle, m_order.begin() + end,
+                [this, axis](int a, int b) {
+                    const float* boxA = &m_boxes[static_cast<size_t>(a) * 6];
+                    const float* boxB = &m_boxes[static_cast<size_t>(b) * 6];
+                    return boxA[axis] + boxA[axis + 3] < boxB[axis] + boxB[axis + 3];
+                });
+
+            node.count = 0;
+            m_nodes[index] = node;
+            int left = buildNode(begin, middle);
+            int right = buildNode(middle, end);
+            m_nodes[index].left = left;
+            m_nodes[index].right = right;
+            return index;
+        }
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+ShapePicker::PickResult ShapePicker::pick(const gp_Lin& ray) const
+{
+    PickResult result;
+    if (m_nodes.empty()) {
+        return result;
+    }
+
+    const double origin[3] = { ray.Location().X(), ray.Location().Y(), ray.Location().Z() };
+    const double direction[3] = { ray.Direction().X(), ray.Direction().Y(), ray.Direction().Z() };
+    double inverse[3];
+    for (int axis = 0; axis < 3; axis++) {
+        inverse[axis] = direction[axis] != 0.0 ? 1.0 / direction[axis] : std::numeric_limits<double>::infinity();
+    }
+
+    // Slab test; returns the entry parameter of the box, or a negative value on a miss
+    auto enterBox = [&](const BvhNode& node, double limit) {
+        double tNear = 0.0;
+        double tFar = limit;
+        for (int axis = 0; axis < 3; axis++) {
+            double t0 = (node.boxMin[axis] - origin[axis]) * inverse[axis];
+            double t1 = (node.boxMax[axis] - origin[axis]) * inverse[axis];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            // A ray parallel to the slab gives NaN for a boundary; treat it as inside
+            if (t0 == t0) {
+                tNear = std::max(tNear, t0);
+            }
+            if (t1 == t1) {
+                tFar = std::min(tFar, t1);
+            }
+            if (tNear > tFar) {
+                return -1.0;
+            }
+        }
+        return tNear;
+    };
+
+    double nearest = std::numeric_limits<double>::infinity();
+    int hitTriangle = -1;
+
+    // Depth-first, nearer child first, skipping nodes behind the nearest hit so far
+    std::vector<int> stack;
+    stack.reserve(64);
+    if (enterBox(m_nodes[0], nearest) >= 0.0) {
+        stack.push_back(0);
+    }
+    while (!stack.empty()) {
+        const BvhNode& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (node.count == 0) {
+            const double tLeft = enterBox(m_nodes[node.left], nearest);
+            const double tRight = enterBox(m_nodes[node.right], nearest);
+            if (tLeft >= 0.0 && tRight >= 0.0) {
+                // The nearer child is popped first
+                if (tLeft <= tRight) {
+                    stack.push_back(node.right);
+                    stack.push_back(node.left);
+                }
+                else {
+                    stack.push_back(node.left);
+                    stack.push_back(node.right);
+                }
+            }
+            else if (tLeft >= 0.0) {
+                stack.push_back(node.left);
+            }
+            else if (tRight >= 0.0) {
+                stack.push_back(node.right);
+            }
+            continue;
+        }
+
+        if (enterBox(node, nearest) < 0.0) {
+            continue;
+        }
+        for (int k = node.first; k < node.first + node.count; k++) {
+            double distance = 0.0;
+            if (intersectTriangle(m_order[k], origin, direction, distance) && distance < nearest) {
+                nearest = distance;
+                hitTriangle = m_order[k];
+            }
+        }
+    }
+
+    if (hitTriangle < 0) {
+        return result;
+    }
+
+    const float* v = &m_vertices[static_cast<size_t>(hitTriangle) * 9];
+    const gp_XYZ p0(v[0], v[1], v[2]);
+    const gp_XYZ p1(v[3], v[4], v[5]);
+    const gp_XYZ p2(v[6], v[7], v[8]);
+    gp_XYZ normal = (p1 - p0).Crossed(p2 - p0);
+    if (normal.Dot(ray.Direction().XYZ()) > 0.0) {
+        normal.Reverse();
+    }
+
+    result.hit = true;
+    result.distance = nearest;
+    result.point = ray.Location().Translated(gp_Vec(ray.Direction()) * nearest);
+    if (normal.Modulus() > 0.0) {
+        result.normal = gp_Dir(normal);
+    }
+    else {
+        result.normal = ray.Direction().Reversed();
+    }
+    result.triangle = hitTriangle;
+    result.faceIndex = m_triangleFaces[hitTriangle];
+    result.face = TopoDS::Face(m_faces(result.faceIndex));
+    return result;
+}
+
+bool ShapePicker::pickEdge(const gp_Lin& ray, PickResult& result, double tolerance) const
+{
+    if (!result.hit || result.faceIndex < 1 || result.faceIndex > static_cast<int>(m_faceEdges.size())) {
+        return false;
+    }
+
+    // Only the edges bounding the hit face can be under the cursor at the hit point; edges
+    // far behind it are excluded through the ray parameter
+    const double squareTolerance = tolerance * tolerance;
+    double best = squareTolerance;
+    int bestEdge = 0;
+    for (const EdgePolyline& polyline : m_faceEdges[result.faceIndex - 1]) {
+        for (int i = polyline.first; i + 1 < polyline.first + polyline.count; i++) {
+            double rayParameter = 0.0;
+            const double squareDistance = raySegmentDistance(ray, m_edgePoints[i], m_edgePoints[i + 1], rayParameter);
+            if (squareDistance <= best && rayParameter >= 0.0 && rayParameter <= result.distance + tolerance) {
+                best = squareDistance;
+                bestEdge = polyline.edge;
+            }
+        }
+    }
+
+    if (bestEdge == 0) {
+        return false;
+    }
+    result.edgeIndex = bestEdge;
+    result.edge = TopoDS::Edge(m_edges(bestEdge));
+    return true;
+}
+
+bool ShapePicker::pickFreeEdge(const gp_Lin& ray, PickResult& result, double tolerance, double toleranceSlope) const
+{
+    // Free edges are few compared with the triangles, so they are tested one by one; the
+    // accepted distance grows along the ray like the pick radius does in perspective, and
+    // an edge lying on the hit face still wins over it
+    const double limit = result.hit ? result.distance : std::numeric_limits<double>::infinity();
+    double best = std::numeric_limits<double>::infinity();
+    double bestParameter = 0.0;
+    int bestEdge = 0;
+    for (const EdgePolyline& polyline : m_freeEdges) {
+        for (int i = polyline.first; i + 1 < polyline.first + polyline.count; i++) {
+            double rayParameter = 0.0;
+            const double squareDistance = raySegmentDistance(ray, m_edgePoints[i], m_edgePoints[i + 1], rayParameter);
+            const double accepted = tolerance + toleranceSlope * std::max(0.0, rayParameter);
+            if (squareDistance <= accepted * accepted && squareDistance < best
+                && rayParameter >= 0.0 && rayParameter <= limit + accepted) {
+                best = squareDistance;
+                bestParameter = rayParameter;
+                bestEdge = polyline.edge;
+            }
+        }
+    }
+
+    if (bestEdge == 0) {
+        return false;
+    }
+    result = PickResult();
+    result.hit = true;
+    result.distance = bestParameter;
+    result.point = ray.Location().Translated(gp_Vec(ray.Direction()) * bestParameter);
+    result.normal = ray.Direction().Reversed();
+    result.edgeIndex = bestEdge;
+    result.edge = TopoDS::Edge(m_edges(bestEdge));
+    return true;
+}
+
+bool ShapePicker::intersectTriangle(int triangle, const double origin[3], const double direction[3], double& distance) const
+{
+    // Moller-Trumbore, two-sided
+    const float* v = &m_vertices[static_cast<size_t>(triangle) * 9];
+    const double edge1[3] = { v[3] - v[0], v[4] - v[1], v[5] - v[2] };
+    const double edge2[3] = { v[6] - v[0], v[7] - v[1], v[8] - v[2] };
+
+    const double h[3] = {
+        direction[1] * edge2[2] - direction[2] * edge2[1],
+        direction[2] * edge2[0] - direction[0] * edge2[2],
+        direction[0] * edge2[1] - direction[1] * edge2[0] };
+    const double det = edge1[0] * h[0] + edge1[1] * h[1] + edge1[2] * h[2];
+    if (std::abs(det) <= 1.0e-30) {
+        return false; // Parallel or degenerate
+    }
+
+    const double invDet = 1.0 / det;
+    const double s[3] = { origin[0] - v[0], origin[1] - v[1], origin[2] - v[2] };
+    const double u = invDet * (s[0] * h[0] + s[1] * h[1] + s[2] * h[2]);
+    if (u < -PARAM_EPSILON || u > 1.0 + PARAM_EPSILON) {
+        return false;
+    }
+
+    const double q[3] = {
+        s[1] * edge1[2] - s[2] * edge1[1],
+        s[2] * edge1[0] - s[0] * edge1[2],
+        s[0] * edge1[1] - s[1] * edge1[0] };
+    const double w = invDet * (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]);
+    if (w < -PARAM_EPSILON || u + w > 1.0 + PARAM_EPSILON) {
+        return false;
+    }
+
+    distance = invDet * (edge2[0] * q[0] + edge2[1] * q[1] + edge2[2] * q[2]);
+    return distance > 0.0;
+}
@@ -1,5 +1,4 @@
 #include "ShapeUtil.h"
-#include <QMessageBox>
 
 // OCCT includes
 #include <TopoDS.hxx>
@@ -10,20 +9,23 @@
 #include <TopExp_Explorer.hxx>
 #include <TopExp.hxx>
 #include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
 #include <BRep_Tool.hxx>
 #include <Poly_Triangulation.hxx>
 #include <Poly_PolygonOnTriangulation.hxx>
 #include <Poly_Polygon3D.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
+#include <BRepTools.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <IMeshTools_Parameters.hxx>
+#include <OSD_Parallel.hxx>
 #include <Precision.hxx>
+#include <Bnd_Box.hxx>
+#include <gp.hxx>
 #include <gp_Trsf.hxx>
 #include <gp_Pnt.hxx>
-#include <gp_Vec.hxx>
+#include <gp_Vec3f.hxx>
 #include <TopAbs.hxx>
-#include <TColgp_Array1OfDir.hxx>
-#include <Bnd_Box.hxx>
-#include <BRepBndLib.hxx>
 
 // Quarter includes
 #include <Inventor/nodes/SoSeparator.h>
@@ -32,36 +34,460 @@
 #include <Inventor/nodes/SoNormalBinding.h>
 #include <Inventor/nodes/SoIndexedFaceSet.h>
 #include <Inventor/nodes/SoIndexedLineSet.h>
+#include <Inventor/nodes/SoLineSet.h>
+#include <Inventor/nodes/SoVertexProperty.h>
 #include <Inventor/nodes/SoPointSet.h>
 #include <Inventor/nodes/SoMaterial.h>
+#include <Inventor/nodes/SoLevelOfDetail.h>
+#include <Inventor/nodes/SoGroup.h>
+#include <Inventor/nodes/SoCallback.h>
+#include <Inventor/nodes/SoInfo.h>
+#include <Inventor/actions/SoGLRenderAction.h>
 #include <Inventor/SbVec3f.h>
+#include <Inventor/SbBox3f.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 // Project includes
 #include "ViewTool.h"
+#include "SoInterleavedTriangleSet.h"
 #include "base.h"
 
-Bnd_Box getBounds(const TopoDS_Shape& shape)
+namespace
 {
-    Bnd_Box bounds;
-    BRepBndLib::Add(shape, bounds);
-    bounds.SetGap(0.0);
+    // Triangles above which a group of faces is split into smaller chunks
+    const int CHUNK_TRIANGLES = 4096;
 
-    return bounds;
-}
+    // Triangulation of one face and where its data goes in the output buffers
+    struct FaceMesh
+    {
+        Handle(Poly_Triangulation) mesh;
+        TopLoc_Location location;
+        int nodeOffset = 0;         // in the shared coordinates
+        int chunk = -1;
+        int triangleOffset = 0;     // in the face set of the chunk
+        // edges whose polyline is taken from this face: edge index and its polygon
+        std::vector<std::pair<int, Handle(Poly_PolygonOnTriangulation)>> edges;
+    };
+
+    // Polyline of an edge that is not bounded by any face
+    struct FreeEdge
+    {
+        int edgeIndex = 0;
+        Handle(Poly_Polygon3D) polygon;
+        TopLoc_Location location;
+    };
 
-Standard_Real getDeflection(const Bnd_Box& bounds, double deviation)
-{
-    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
-    bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    // Faces drawn by one face set and line set; edges are drawn with the face that owns them
+    struct Chunk
+    {
+        std::vector<int> faces;     // indexes of the face meshes
+        int nodeOffset = 0;         // first face node of the chunk
+        int numNodes = 0;
+        int numTriangles = 0;
+        int numLines = 0;           // polyline indexes including the end markers
+        int numPolylines = 0;
+    };
+
+    // Converted geometry of a shape at one tessellation quality
+    struct CachedGeometry
+    {
+        TopoDS_Shape shape;
+        double deflection = 0.0;
+        double angularDeflection = 0.0;
+        SoSeparator* geometry = nullptr;  // referenced while cached, never part of a scene graph
+        int triangles = 0;
+    };
+
+    // Tessellation cache shared by all viewers, most recently used entry first; the cached
+    // nodes are only touched with cacheMutex held, displays get copies of them
+    std::mutex cacheMutex;
+    // The capacity is counted in triangles, as a part displayed with levels of detail takes
+    // one entry per level and parts differ in size by orders of magnitude. The list keeps the
+    // LRU order; the index finds the entries of a located shape without scanning it.
+    using GeometryList = std::list<CachedGeometry>;
+    GeometryList geometryCache;
+    std::unordered_map<TopoDS_Shape, std::vector<GeometryList::iterator>, Jumpers::ShapeMapHasher> geometryIndex;
+    int geometryCacheTriangles = 0;
+    int geometryCacheCapacity = 4000000;
+
+    // Projected chunk size in pixels below which a chunk is skipped, and the nodes the
+    // triangles are drawn with; guarded by cacheMutex
+    float minChunkScreenArea = 1.0f;
+    ShapeUtil::GeometryFormat geometryFormatSetting = ShapeUtil::GeometryFormat::IndexedFaceSet;
+
+    // Whether chunks are built with the callbacks that count them; SoCallback nodes break the
+    // render caches of the separators above them, so they are only added on request.
+    // Guarded by cacheMutex.
+    bool countRenderStatistics = false;
+
+    // Counted by the chunk callbacks during GL rendering, which runs on the GUI thread only
+    ShapeUtil::RenderStatistics renderStats;
+
+    // Meets a chunk while rendering; the chunk counts as culled until it is drawn
+    void chunkMetCallback(void* data, SoAction* action)
+    {
+        if (action->isOfType(SoGLRenderAction::getClassTypeId())) {
+            const int numTriangles = static_cast<int>(reinterpret_cast<intptr_t>(data));
+            renderStats.chunks++;
+            renderStats.culledChunks++;
+            renderStats.triangles += numTriangles;
+            renderStats.culledTriangles += numTriangles;
+        }
+    }
 
-    // calculating the deflection value
-    return ((xMax - xMin) + (yMax - yMin) + (zMax - zMin)) / 300.0 * deviation;
-}
+    // Reached only when the chunk passed the view volume and screen size tests
+    void chunkDrawnCallback(void* data, SoAction* action)
+    {
+        if (action->isOfType(SoGLRenderAction::getClassTypeId())) {
+            const int numTriangles = static_cast<int>(reinterpret_cast<intptr_t>(data));
+            renderStats.culledChunks--;
+            renderStats.culledTriangles -= numTriangles;
+        }
+    }
 
-Standard_Real getDeflection(const TopoDS_Shape& shape, double deviation)
-{
-    return getDeflection(getBounds(shape), deviation);
+    // Splits the faces into chunks of at most CHUNK_TRIANGLES triangles by median cuts along
+    // the longest extent of the face centers; a single larger face makes a chunk of its own
+    void splitChunks(std::vector<int>::iterator begin, std::vector<int>::iterator end,
+        const std::vector<FaceMesh>& faceMeshes, const std::vector<SbVec3f>& centers, std::vector<Chunk>& chunks)
+    {
+        int numTriangles = 0;
+        SbBox3f bounds;
+        for (auto it = begin; it != end; ++it) {
+            numTriangles += faceMeshes[*it].mesh->NbTriangles();
+            bounds.extendBy(centers[*it]);
+        }
+
+        if (numTriangles <= CHUNK_TRIANGLES || end - begin == 1) {
+            Chunk chunk;
+            chunk.faces.assign(begin, end);
+            chunks.push_back(chunk);
+            return;
+        }
+
+        const SbVec3f size = bounds.getMax() - bounds.getMin();
+        int axis = size[1] > size[0] ? 1 : 0;
+        if (size[2] > size[axis]) {
+            axis = 2;
+        }
+
+        auto middle = begin + (end - begin) / 2;
+        std::nth_element(begin, middle, end, [&centers, axis](int a, int b) {
+            return centers[a][axis] < centers[b][axis];
+        });
+        splitChunks(begin, middle, faceMeshes, centers, chunks);
+        splitChunks(middle, end, faceMeshes, centers, chunks);
+    }
+
+    // Wraps the sets of one chunk into a culling separator. Below the minimum screen area
+    // the level of detail switches to an empty node, which skips sub-pixel chunks.
+    SoSeparator* makeChunkNode(SoNode* faceSet, SoNode* lineSet, int numTriangles, float minScreenArea, bool counted)
+    {
+        SoGroup* detail = new SoGroup;
+        if (counted) {
+            SoCallback* drawn = new SoCallback;
+            drawn->setCallback(chunkDrawnCallback, reinterpret_cast<void*>(static_cast<intptr_t>(numTriangles)));
+            detail->addChild(drawn);
+        }
+        detail->addChild(faceSet);
+        if (lineSet) {
+            detail->addChild(lineSet);
+        }
+
+        SoSeparator* chunkSep = new SoSeparator;
+        chunkSep->renderCulling = SoSeparator::ON;
+        if (minScreenArea > 0.0f) {
+            SoLevelOfDetail* lod = new SoLevelOfDetail;
+            lod->screenArea.setValue(minScreenArea);
+            lod->addChild(detail);
+            lod->addChild(new SoInfo);
+            chunkSep->addChild(lod);
+        }
+        else {
+            chunkSep->addChild(detail);
+        }
+        return chunkSep;
+    }
+
+    // Converts the scratch face and edge indexes of every chunk into a triangle buffer over the
+    // chunk's own nodes and a line set carrying copies of its polyline nodes. The nodes are
+    // created here and their arrays filled in parallel.
+    void buildTriangleBuffers(const std::vector<Chunk>& chunks, const std::vector<SbVec3f>& verts,
+        const std::vector<SbVec3f>& norms, const std::vector<std::vector<int32_t>>& scratchIndex,
+        const std::vector<std::vector<int32_t>>& scratchLines, std::vector<SoNode*>& chunkFaces,
+        std::vector<SoNode*>& chunkEdges)
+    {
+        const int numChunks = static_cast<int>(chunks.size());
+
+        std::vector<SoLineSet*> lineSets(numChunks, nullptr);
+        std::vector<SoVertexProperty*> properties(numChunks, nullptr);
+        std::vector<SbVec3f*> lineVerts(numChunks, nullptr);
+        std::vector<SbVec3f*> lineNorms(numChunks, nullptr);
+        std::vector<int32_t*> lineCounts(numChunks, nullptr);
+        for (int c = 0; c < numChunks; c++) {
+            if (chunks[c].numPolylines == 0) {
+                continue;
+            }
+
+            const int numLineNodes = chunks[c].numLines - chunks[c].numPolylines;
+            properties[c] = new SoVertexProperty;
+            properties[c]->normalBinding = SoVertexProperty::PER_VERTEX;
+            properties[c]->vertex.setNum(numLineNodes);
+            properties[c]->normal.setNum(numLineNodes);
+            lineSets[c] = new SoLineSet;
+            lineSets[c]->vertexProperty = properties[c];
+            lineSets[c]->numVertices.setNum(chunks[c].numPolylines);
+
+            lineVerts[c] = properties[c]->vertex.startEditing();
+            lineNorms[c] = properties[c]->normal.startEditing();
+            lineCounts[c] = lineSets[c]->numVertices.startEditing();
+        }
+
+        std::vector<std::vector<float>> vertices(numChunks);
+        std::vector<std::vector<uint32_t>> indices(numChunks);
+        OSD_Parallel::For(0, numChunks, [&](int c) {
+            const Chunk& chunk = chunks[c];
+
+            // normal followed by position for every node of the chunk
+            std::vector<float>& chunkVertices = vertices[c];
+            chunkVertices.resize(static_cast<size_t>(chunk.numNodes) * 6);
+            for (int i = 0; i < chunk.numNodes; i++) {
+                const SbVec3f& n = norms[chunk.nodeOffset + i];
+                const SbVec3f& p = verts[chunk.nodeOffset + i];
+                float* vertex = &chunkVertices[static_cast<size_t>(i) * 6];
+                vertex[0] = n[0];
+                vertex[1] = n[1];
+                vertex[2] = n[2];
+                vertex[3] = p[0];
+                vertex[4] = p[1];
+                vertex[5] = p[2];
+            }
+
+            // drop the end markers and make the indexes local to the chunk
+            const std::vector<int32_t>& index = scratchIndex[c];
+            std::vector<uint32_t>& chunkIndices = indices[c];
+            chunkIndices.resize(static_cast<size_t>(chunk.numTriangles) * 3);
+            for (int t = 0; t < chunk.numTriangles; t++) {
+                for (int k = 0; k < 3; k++) {
+                    chunkIndices[3 * t + k] = static_cast<uint32_t>(index[4 * t + k] - chunk.nodeOffset);
+                }
+            }
+
+            if (lineSets[c]) {
+                int node = 0, polyline = 0, count = 0;
+                for (int32_t coordIndex : scratchLines[c]) {
+                    if (coordIndex < 0) {
+                        lineCounts[c][polyline++] = count;
+                        count = 0;
+                        continue;
+                    }
+                    lineVerts[c][node] = verts[coordIndex];
+                    lineNorms[c][node] = norms[coordIndex];
+                    node++;
+                    count++;
+                }
+            }
+        });
+
+        for (int c = 0; c < numChunks; c++) {
+            SoInterleavedTriangleSet* triangleSet = new SoInterleavedTriangleSet;
+            triangleSet->setGeometry(std::move(vertices[c]), indices[c]);
+            chunkFaces[c] = triangleSet;
+
+            if (lineSets[c]) {
+                properties[c]->vertex.finishEditing();
+                properties[c]->normal.finishEditing();
+                lineSets[c]->numVertices.finishEditing();
+                chunkEdges[c] = lineSets[c];
+            }
+        }
+    }
+
+    // Drops the least recently used entries above the capacity; cacheMutex must be held
+    void trimGeometryCache()
+    {
+        while (!geometryCache.empty() && geometryCacheTriangles > geometryCacheCapacity) {
+            GeometryList::iterator last = std::prev(geometryCache.end());
+            auto indexed = geometryIndex.find(last->shape);
+            std::vector<GeometryList::iterator>& entries = indexed->second;
+            entries.erase(std::find(entries.begin(), entries.end(), last));
+            if (entries.empty()) {
+                geometryIndex.erase(indexed);
+            }
+
+            geometryCacheTriangles -= last->triangles;
+            last->geometry->unref();
+            geometryCache.erase(last);
+        }
+    }
+
+    // Triangles in the face triangulations of a shape, at least one so that geometry of
+    // edges only still counts against the cache capacity
+    int countTriangles(const TopoDS_Shape& shape)
+    {
+        int triangles = 1;
+        for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+            TopLoc_Location loc;
+            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), loc);
+            if (!mesh.IsNull()) {
+                triangles += mesh->NbTriangles();
+            }
+        }
+        return triangles;
+    }
+
+    // Referenced copy of cached geometry for one display; Coin reference counts and auditor
+    // lists are not thread safe, so a node that a scene graph holds is never cached
+    SoSeparator* copyGeometry(const SoSeparator* geometry)
+    {
+        SoSeparator* copy = static_cast<SoSeparator*>(geometry->copy());
+        copy->ref();
+        return copy;
+    }
+
+    // Wraps the geometry of one display with its material
+    SoSeparator* makeShapeNode(SoSeparator* geometry, const SbColor& color)
+    {
+        SoSeparator* shapeSep = new SoSeparator;
+
+        SoMaterial* material = new SoMaterial;
+        material->diffuseColor.setValue(color);
+        material->specularColor.setValue(1.0, 1.0, 1.0);
+        material->shininess.setValue(0.5);
+
+        shapeSep->addChild(material);
+        if (geometry) {
+            shapeSep->addChild(geometry);
+        }
+        return shapeSep;
+    }
+
+    // Coarsest deflection of the face triangulations, or a negative value if a face has none
+    double meshedDeflection(const TopoDS_Shape& shape)
+    {
+        double deflection = 0.0;
+        for (TopExp_Explorer exp(shape, TopAbs_FACE); exp.More(); exp.Next()) {
+            TopLoc_Location loc;
+            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(exp.Current()), loc);
+            if (mesh.IsNull()) {
+                return -1.0;
+            }
+            deflection = std::max(deflection, mesh->Deflection());
+        }
+        return deflection;
+    }
+
+    // Writes the nodes, normals, triangle indexes and edge polylines of one face.
+    // Each face owns the ranges given by its offsets, so faces can be filled concurrently;
+    // index and lines are the buffers of the face's chunk. Every node is transformed once; normals are taken from the triangulation when it
+    // stores them, otherwise accumulated from the float triangle normals.
+    void fillFace(const TopoDS_Face& face, const FaceMesh& faceMesh, SbVec3f* verts, SbVec3f* norms,
+        int32_t* index, int32_t* lines, const std::vector<int>& lineOffsets)
+    {
+        const Handle(Poly_Triangulation)& mesh = faceMesh.mesh;
+        const int nodeOffset = faceMesh.nodeOffset;
+        const int nbNodes = mesh->NbNodes();
+        const int nbTriangles = mesh->NbTriangles();
+        SbVec3f* faceVerts = verts + nodeOffset;
+        SbVec3f* faceNorms = norms + nodeOffset;
+        int32_t* faceIndex = index + faceMesh.triangleOffset * 4;
+
+        // the location of the face as a 3x4 matrix, applied to the whole node array
+        double matrix[3][4] = { { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0, 0.0 }, { 0.0, 0.0, 1.0, 0.0 } };
+        if (!faceMesh.location.IsIdentity()) {
+            const gp_Trsf& trsf = faceMesh.location.Transformation();
+            for (int r = 0; r < 3; r++) {
+                for (int c = 0; c < 4; c++) {
+                    matrix[r][c] = trsf.Value(r + 1, c + 1);
+                }
+            }
+        }
+
+        // positions stay in double until they are placed, so parts far from the origin keep their precision
+        for (int i = 0; i < nbNodes; i++) {
+            const gp_Pnt p = mesh->Node(i + 1);
+            faceVerts[i].setValue(
+                static_cast<float>(matrix[0][0] * p.X() + matrix[0][1] * p.Y() + matrix[0][2] * p.Z() + matrix[0][3]),
+                static_cast<float>(matrix[1][0] * p.X() + matrix[1][1] * p.Y() + matrix[1][2] * p.Z() + matrix[1][3]),
+                static_cast<float>(matrix[2][0] * p.X() + matrix[2][1] * p.Y() + matrix[2][2] * p.Z() + matrix[2][3]));
+        }
+
+        // change orientation of the triangles and normals if the face is reversed
+        const bool reversed = face.Orientation() != TopAbs_FORWARD;
+        const bool storedNormals = mesh->HasNormals();
+        if (storedNormals) {
+            const float rotation[3][3] = {
+                { float(matrix[0][0]), float(matrix[0][1]), float(matrix[0][2]) },
+                { float(matrix[1][0]), float(matrix[1][1]), float(matrix[1][2]) },
+                { float(matrix[2][0]), float(matrix[2][1]), float(matrix[2][2]) } };
+            const float sign = reversed ? -1.0f : 1.0f;
+            gp_Vec3f n;
+            for (int i = 0; i < nbNodes; i++) {
+                mesh->Normal(i + 1, n);
+                faceNorms[i].setValue(
+                    sign * (rotation[0][0] * n.x() + rotation[0][1] * n.y() + rotation[0][2] * n.z()),
+                    sign * (rotation[1][0] * n.x() + rotation[1][1] * n.y() + rotation[1][2] * n.z()),
+                    sign * (rotation[2][0] * n.x() + rotation[2][1] * n.y() + rotation[2][2] * n.z()));
+            }
+        }
+        else {
+            for (int i = 0; i < nbNodes; i++) {
+                faceNorms[i].setValue(0.0f, 0.0f, 0.0f);
+            }
+        }
+
+        for (int g = 0; g < nbTriangles; g++) {
+            Standard_Integer N1, N2, N3;
+            mesh->Triangle(g + 1).Get(N1, N2, N3);
+            if (reversed) {
+                std::swap(N1, N2);
+            }
+            N1--;
+            N2--;
+            N3--;
+
+            // set the index vector with the 3 point indexes and the end delimiter
+            faceIndex[4 * g] = nodeOffset + N1;
+            faceIndex[4 * g + 1] = nodeOffset + N2;
+            faceIndex[4 * g + 2] = nodeOffset + N3;
+            faceIndex[4 * g + 3] = SO_END_FACE_INDEX;
+
+            if (!storedNormals) {
+                // area weighted normal of the placed triangle, shared by its 3 points
+                const SbVec3f normal = (faceVerts[N2] - faceVerts[N1]).cross(faceVerts[N3] - faceVerts[N1]);
+                faceNorms[N1] += normal;
+                faceNorms[N2] += normal;
+                faceNorms[N3] += normal;
+            }
+        }
+
+        for (int i = 0; i < nbNodes; i++) {
+            SbVec3f& n = faceNorms[i];
+            if (n.sqrLength() > 0.0f) {
+                n.normalize();
+            }
+        }
+
+        // handling the edges lying on this face; their nodes were placed with the face nodes
+        for (const auto& edge : faceMesh.edges) {
+            if (lineOffsets[edge.first] < 0) {
+                continue;
+            }
+            int32_t* lineCoords = lines + lineOffsets[edge.first];
+            const TColStd_Array1OfInteger& indices = edge.second->Nodes();
+            for (Standard_Integer i = indices.Lower(); i <= indices.Upper(); i++) {
+                *lineCoords++ = nodeOffset + indices(i) - 1;
+            }
+            *lineCoords = -1;
+        }
+    }
 }
 
 // ShapeUtil implementation
@@ -107,367 +533,537 @@ SoNode* ShapeUtil::convertSingleShape(TopoDS_Shape shape, double deviation, doub
 {
     try
     {
-        SoSeparator* shapeSep = new SoSeparator;
-        SoCoordinate3* coords = new SoCoordinate3;
-        coords->ref();
-        SoNormal* norm = new SoNormal;
-        norm->ref();
-        SoNormalBinding* normalBinding = new SoNormalBinding;
-        normalBinding->ref();
-        SoIndexedFaceSet* faceSet = new SoIndexedFaceSet;
-        faceSet->ref();
-        SoIndexedLineSet* lineSet = new SoIndexedLineSet;
-        lineSet->ref();
-        SoPointSet* pointSet = new SoPointSet;
-        pointSet->ref();
-
         if (ViewTool::isShapeEmpty(shape)) {
-            coords->point.setNum(0);
-            norm->vector.setNum(0);
-            faceSet->coordIndex.setNum(0);
-            lineSet->coordIndex.setNum(0);
-            pointSet->startIndex.setValue(0);
-            return shapeSep;
+            return new SoSeparator;
         }
 
-        int numTriangles = 0, numNodes = 0, numNorms = 0, numFaces = 0, numEdges = 0, numLines = 0;
+        return convertShape(shape, ViewTool::getDeflection(shape, deviation), angularDeflection, color);
+    }
+    catch (const Standard_Failure& e) {
+        //spdlog::error(e.GetMessageString());
+        return nullptr;
+    }
+    catch (...) {
+        //spdlog::error("Unknown error during shape conversion");
+        return nullptr;
+    }
+}
+
+SoSeparator* ShapeUtil::convertShape(const TopoDS_Shape& shape, double deflection, double angularDeflection, SbColor color)
+{
+    if (ViewTool::isShapeEmpty(shape)) {
+        return new SoSeparator;
+    }
+
+    SoSeparator* geometry = tessellate(shape, deflection, angularDeflection, false);
+    if (!geometry) {
+        return nullptr;
+    }
+
+    SoSeparator* shapeSep = makeShapeNode(geometry, color);
+    geometry->unref();
+    return shapeSep;
+}
+
+SoNode* ShapeUtil::convertShapeLevels(const TopoDS_Shape& shape, const std::vector<DetailLevel>& levels, SbColor color)
+{
+    if (ViewTool::isShapeEmpty(shape) || levels.empty()) {
+        return new SoSeparator;
+    }
+
+    // Coarse levels are meshed first so that every finer pass refines the triangulation
+    // the previous one left; tessellate() returns the geometries referenced
+    std::vector<SoSeparator*> geometries(levels.size(), nullptr);
+    bool complete = true;
+    for (int i = static_cast<int>(levels.size()) - 1; i >= 0 && complete; i--) {
+        geometries[i] = tessellate(shape, levels[i].deflection, levels[i].angularDeflection, true);
+        complete = geometries[i] != nullptr;
+    }
 
-        std::set<int> faceEdges;
+    SoSeparator* shapeSep = nullptr;
+    if (complete) {
+        // children are ordered finest first; a level is used while the projected bounding
+        // box covers at least its screen area, the last level below that
+        SoLevelOfDetail* lod = new SoLevelOfDetail;
+        for (size_t i = 0; i < levels.size(); i++) {
+            lod->addChild(geometries[i]);
+            if (i + 1 < levels.size()) {
+                lod->screenArea.set1Value(static_cast<int>(i), levels[i].minScreenArea);
+            }
+        }
+        shapeSep = makeShapeNode(nullptr, color);
+        shapeSep->addChild(lod);
+    }
 
-        Standard_Real deflection = getDeflection(shape, deviation);
+    for (SoSeparator* geometry : geometries) {
+        if (geometry) {
+            geometry->unref();
+        }
+    }
+    return shapeSep;
+}
+
+SoSeparator* ShapeUtil::tessellate(const TopoDS_Shape& shape, double deflection, double angularDeflection, bool exactLevel)
+{
+    {
+        // A cached tessellation is reused if it is at least as fine as requested, but not
+        // so much finer that it costs more to draw; the bounding box that the deflection is
+        // derived from shrinks slightly once the shape carries a triangulation
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto indexed = geometryIndex.find(shape);
+        if (indexed != geometryIndex.end()) {
+            for (GeometryList::iterator it : indexed->second) {
+                if (it->deflection <= deflection * (1.0 + 1.0e-6) && it->deflection >= 0.5 * deflection
+                    && it->angularDeflection <= angularDeflection) {
+                    // moving the entry keeps the iterators of the index valid
+                    geometryCache.splice(geometryCache.begin(), geometryCache, it);
+                    return copyGeometry(it->geometry);
+                }
+            }
+        }
+    }
 
-        if (deflection < gp::Resolution()) {
-            deflection = Precision::Confusion();
+    SoSeparator* geometry = nullptr;
+    int triangles = 0;
+    try
+    {
+        // A level of detail must not draw a much finer mesh the shape already carries;
+        // such a level is meshed on a copy of the topology that shares the geometry
+        TopoDS_Shape meshed = shape;
+        if (exactLevel) {
+            double existing = meshedDeflection(shape);
+            if (existing >= 0.0 && existing < 0.5 * deflection) {
+                BRepBuilderAPI_Copy copier(shape, Standard_False, Standard_False);
+                meshed = copier.Shape();
+            }
         }
 
+        meshShape(meshed, deflection, angularDeflection);
+        geometry = buildGeometry(meshed);
+        triangles = countTriangles(meshed);
+    }
+    catch (const Standard_Failure& e) {
+        //spdlog::error(e.GetMessageString());
+    }
+    if (!geometry) {
+        return nullptr;
+    }
+    geometry->ref();
+
+    // the built geometry goes to the caller, the cache keeps a copy of its own
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (geometryCacheCapacity > 0 && triangles <= geometryCacheCapacity) {
+        CachedGeometry entry;
+        entry.shape = shape;
+        entry.deflection = deflection;
+        entry.angularDeflection = angularDeflection;
+        entry.geometry = copyGeometry(geometry);
+        entry.triangles = triangles;
+        geometryCacheTriangles += triangles;
+        geometryCache.push_front(entry);
+        geometryIndex[shape].push_back(geometryCache.begin());
+        trimGeometryCache();
+    }
+    return geometry;
+}
 
-        Standard_Real AngDeflectionRads = angularDeflection;
+bool ShapeUtil::hasValidTriangulation(const TopoDS_Shape& shape, double deflection)
+{
+    // every face must carry a triangulation with a deflection not above the requested one,
+    // and every edge its polygon on that triangulation
+    return BRepTools::Triangulation(shape, deflection, Standard_True);
+}
 
-        IMeshTools_Parameters meshParams;
-        meshParams.Deflection = deflection;
-        meshParams.Relative = Standard_False;
-        meshParams.Angle = AngDeflectionRads;
-        meshParams.InParallel = Standard_True;
-        meshParams.AllowQualityDecrease = Standard_True;
+void ShapeUtil::clearTessellationCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (CachedGeometry& entry : geometryCache) {
+        entry.geometry->unref();
+    }
+    geometryCache.clear();
+    geometryIndex.clear();
+    geometryCacheTriangles = 0;
+}
 
-        BRepMesh_IncrementalMesh importMesh(shape, meshParams);
+void ShapeUtil::setTessellationCacheCapacity(int capacity)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    geometryCacheCapacity = std::max(0, capacity);
+    trimGeometryCache();
+}
 
+void ShapeUtil::setMinChunkScreenArea(float area)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        minChunkScreenArea = std::max(0.0f, area);
+    }
+    clearTessellationCache();
+}
 
-        TopLoc_Location aLoc;
-        shape.Location(aLoc);
+void ShapeUtil::setGeometryFormat(GeometryFormat format)
+{
+    if (format == GeometryFormat::TriangleBuffer) {
+        SoInterleavedTriangleSet::initClass();
+    }
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        geometryFormatSetting = format;
+    }
+    clearTessellationCache();
+}
 
-        // count triangles and nodes in the mesh
-        TopTools_IndexedMapOfShape faceMap;
-        TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
-        for (int i = 1; i <= faceMap.Extent(); i++) {
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(faceMap(i)), aLoc);
+ShapeUtil::GeometryFormat ShapeUtil::geometryFormat()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return geometryFormatSetting;
+}
 
-            if (mesh.IsNull()) {
-                mesh = ViewTool::triangulationOfFace(TopoDS::Face(faceMap(i)));
-            }
+void ShapeUtil::setRenderStatistics(bool enabled)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        countRenderStatistics = enabled;
+    }
+    clearTessellationCache();
+}
 
-            // Note: we must also count empty faces
-            if (!mesh.IsNull()) {
-                numTriangles += mesh->NbTriangles();
-                numNodes += mesh->NbNodes();
-                numNorms += mesh->NbNodes();
-            }
+bool ShapeUtil::renderStatisticsEnabled()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return countRenderStatistics;
+}
 
-            TopExp_Explorer xp;
-            for (xp.Init(faceMap(i), TopAbs_EDGE); xp.More(); xp.Next()) {
-                faceEdges.insert(Jumpers::ShapeMapHasher{}(xp.Current()));
-            }
-            numFaces++;
-        }
+void ShapeUtil::resetRenderStatistics()
+{
+    renderStats = RenderStatistics();
+}
 
-        // get an indexed map of edges
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
+ShapeUtil::RenderStatistics ShapeUtil::renderStatistics()
+{
+    return renderStats;
+}
 
-        // key is the edge number, value the coord indexes. This is needed to keep the same order as
-        // the edges.
-        std::map<int, std::vector<int32_t>> lineSetMap;
-        std::set<int> edgeIdxSet;
-        std::vector<int32_t> edgeVector;
+void ShapeUtil::meshShape(const TopoDS_Shape& shape, double deflection, double angularDeflection)
+{
+    // Since OCCT 7.6 a value of equal 0 is not allowed any more
+    if (deflection < gp::Resolution()) {
+        deflection = Precision::Confusion();
+    }
 
-        // count and index the edges
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            edgeIdxSet.insert(i);
-            numEdges++;
+    // keep a triangulation from export or analysis when it is already fine enough
+    if (hasValidTriangulation(shape, deflection)) {
+        return;
+    }
 
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            TopLoc_Location aLoc;
+    IMeshTools_Parameters meshParams;
+    meshParams.Deflection = deflection;
+    meshParams.Relative = Standard_False;
+    meshParams.Angle = angularDeflection;
+    meshParams.InParallel = Standard_True;
+    meshParams.AllowQualityDecrease = Standard_True;
 
+    BRepMesh_IncrementalMesh importMesh(shape, meshParams);
+}
 
-            int hash = Jumpers::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = ViewTool::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    int nbNodesInEdge = aPoly->NbNodes();
-                    numNodes += nbNodesInEdge;
-                }
-            }
-        }
+SoSeparator* ShapeUtil::convertMeshedShape(const TopoDS_Shape& shape, SbColor color)
+{
+    if (ViewTool::isShapeEmpty(shape)) {
+        return new SoSeparator;
+    }
 
-        // handling of the vertices
-        TopTools_IndexedMapOfShape vertexMap;
-        TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
-        numNodes += vertexMap.Extent();
+    SoSeparator* geometry = buildGeometry(shape);
+    return geometry ? makeShapeNode(geometry, color) : nullptr;
+}
 
-        // create memory for the nodes and indexes
-        coords->point.setNum(numNodes);
-        norm->vector.setNum(numNorms);
-        faceSet->coordIndex.setNum(numTriangles * 4);
-        //faceSet->partIndex.setNum(numFaces);
+SoSeparator* ShapeUtil::buildGeometry(const TopoDS_Shape& shape)
+{
+    try
+    {
+        float minScreenArea = 0.0f;
+        GeometryFormat format = GeometryFormat::IndexedFaceSet;
+        bool counted = false;
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            minScreenArea = minChunkScreenArea;
+            format = geometryFormatSetting;
+            counted = countRenderStatistics;
+        }
+        const bool triangleBuffers = format == GeometryFormat::TriangleBuffer;
 
-        // get the raw memory for fast fill up
-        SbVec3f* verts = coords->point.startEditing();
-        SbVec3f* norms = norm->vector.startEditing();
-        int32_t* index = faceSet->coordIndex.startEditing();
-        // int32_t* parts = faceSet->partIndex.startEditing();
+        SoSeparator* shapeSep = new SoSeparator;
+
+        int numTriangles = 0, numNodes = 0;
 
-         // preset the normal vector with null vector
-        for (int i = 0; i < numNorms; i++) {
-            norms[i] = SbVec3f(0.0, 0.0, 0.0);
+        // get an indexed map of edges with the faces they bound; an edge without
+        // faces is free. Membership is kept as bits over the edge indexes.
+        TopTools_IndexedDataMapOfShapeListOfShape edgeMap;
+        TopExp::MapShapesAndAncestors(shape, TopAbs_EDGE, TopAbs_FACE, edgeMap);
+        std::vector<bool> faceEdges(edgeMap.Extent() + 1, false);
+        std::vector<bool> edgeTaken(edgeMap.Extent() + 1, false);
+        for (int i = 1; i <= edgeMap.Extent(); i++) {
+            faceEdges[i] = !edgeMap(i).IsEmpty();
         }
 
-        int ii = 0, faceNodeOffset = 0, faceTriaOffset = 0;
-        for (int i = 1; i <= faceMap.Extent(); i++, ii++) {
-            TopLoc_Location aLoc;
+        // count the triangles in the mesh and find the edge polylines of each face
+        TopTools_IndexedMapOfShape faceMap;
+        TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
+        std::vector<FaceMesh> faceMeshes(faceMap.Extent());
+        std::vector<int> meshedFaces;
+        for (int i = 1; i <= faceMap.Extent(); i++) {
             const TopoDS_Face& actFace = TopoDS::Face(faceMap(i));
-            // get the mesh of the shape
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace, aLoc);
-            if (mesh.IsNull()) {
-                mesh = ViewTool::triangulationOfFace(actFace);
+            FaceMesh& faceMesh = faceMeshes[i - 1];
+            faceMesh.mesh = BRep_Tool::Triangulation(actFace, faceMesh.location);
+            if (faceMesh.mesh.IsNull()) {
+                faceMesh.mesh = ViewTool::triangulationOfFace(actFace);
+                faceMesh.location = TopLoc_Location();
+            }
+
+            if (faceMesh.mesh.IsNull()) {
                 continue;
             }
 
-            //if (mesh.IsNull()) {
-            //    parts[ii] = 0;
-            //    continue;
-            //}
+            numTriangles += faceMesh.mesh->NbTriangles();
+            meshedFaces.push_back(i - 1);
 
-            // getting the transformation of the shape/face
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!aLoc.IsIdentity()) {
-                identity = false;
-                myTransf = aLoc.Transformation();
-            }
-
-            // getting size of node and triangle array of this face
-            int nbNodesInFace = mesh->NbNodes();
-            int nbTriInFace = mesh->NbTriangles();
-            // check orientation
-            TopAbs_Orientation orient = actFace.Orientation();
-
-            int numNodes = mesh->NbNodes();
-            TColgp_Array1OfDir Normals(1, numNodes);
-
-            //if (normalsFromUV) {
-            //    Part::Tools::getPointNormals(actFace, mesh, Normals);
-            //}
-
-            for (int g = 1; g <= nbTriInFace; g++) {
-                // Get the triangle
-                Standard_Integer N1, N2, N3;
-                mesh->Triangle(g).Get(N1, N2, N3);
-
-                // change orientation of the triangle if the face is reversed
-                if (orient != TopAbs_FORWARD) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
+            // the polyline of a shared edge is taken from the first face that has one
+            TopExp_Explorer xp;
+            for (xp.Init(actFace, TopAbs_EDGE); xp.More(); xp.Next()) {
+                const TopoDS_Edge& curEdge = TopoDS::Edge(xp.Current());
+                int edgeIndex = edgeMap.FindIndex(curEdge);
+                if (edgeTaken[edgeIndex]) {
+                    continue;
                 }
 
-
-                gp_Pnt V1(mesh->Node(N1)), V2(mesh->Node(N2)), V3(mesh->Node(N3));
-
-                // get the 3 normals of this triangle
-                gp_Vec NV1, NV2, NV3;
-                //if (normalsFromUV) {
-                //    NV1.SetXYZ(Normals(N1).XYZ());
-                //    NV2.SetXYZ(Normals(N2).XYZ());
-                //    NV3.SetXYZ(Normals(N3).XYZ());
-                //}
-                //else {
-                //    gp_Vec v1 = Base::convertTo<gp_Vec>(V1);
-                //    gp_Vec v2 = Base::convertTo<gp_Vec>(V2);
-                //    gp_Vec v3 = Base::convertTo<gp_Vec>(V3);
-
-                //    gp_Vec normal = (v2 - v1) ^ (v3 - v1);
-                //    NV1 = normal;
-                //    NV2 = normal;
-                //    NV3 = normal;
-                //}
-
-                gp_Vec v1 = Base::convertTo<gp_Vec>(V1);
-                gp_Vec v2 = Base::convertTo<gp_Vec>(V2);
-                gp_Vec v3 = Base::convertTo<gp_Vec>(V3);
-
-                gp_Vec normal = (v2 - v1) ^ (v3 - v1);
-                NV1 = normal;
-                NV2 = normal;
-                NV3 = normal;
-
-                // transform the vertices and normals to the place of the face
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
+                Handle(Poly_PolygonOnTriangulation) aPoly =
+                    BRep_Tool::PolygonOnTriangulation(curEdge, faceMesh.mesh, faceMesh.location);
+                if (aPoly.IsNull()) {
+                    continue;  // polygon does not exist
                 }
+                faceMesh.edges.emplace_back(edgeIndex, aPoly);
+                edgeTaken[edgeIndex] = true;
+            }
+        }
 
-                // add the normals for all points of this triangle
-                norms[faceNodeOffset + N1 - 1] += Base::convertTo<SbVec3f>(NV1);
-                norms[faceNodeOffset + N2 - 1] += Base::convertTo<SbVec3f>(NV2);
-                norms[faceNodeOffset + N3 - 1] += Base::convertTo<SbVec3f>(NV3);
+        // group the faces into spatially coherent chunks, so that Coin can cull the parts of a
+        // large shape that are out of view or too small on screen
+        std::vector<Chunk> chunks;
+        if (numTriangles <= CHUNK_TRIANGLES) {
+            Chunk chunk;
+            chunk.faces = meshedFaces;
+            chunks.push_back(chunk);
+        }
+        else {
+            std::vector<SbVec3f> centers(faceMeshes.size());
+            OSD_Parallel::For(0, static_cast<int>(meshedFaces.size()), [&](int i) {
+                const FaceMesh& faceMesh = faceMeshes[meshedFaces[i]];
+                Bnd_Box box;
+                faceMesh.mesh->MinMax(box, faceMesh.location.Transformation());
+                if (!box.IsVoid()) {
+                    const gp_Pnt center((box.CornerMin().XYZ() + box.CornerMax().XYZ()) * 0.5);
+                    centers[meshedFaces[i]] = Base::convertTo<SbVec3f>(center);
+                }
+            });
+            splitChunks(meshedFaces.begin(), meshedFaces.end(), faceMeshes, centers, chunks);
+        }
 
-                // set the vertices
-                verts[faceNodeOffset + N1 - 1] = Base::convertTo<SbVec3f>(V1);
-                verts[faceNodeOffset + N2 - 1] = Base::convertTo<SbVec3f>(V2);
-                verts[faceNodeOffset + N3 - 1] = Base::convertTo<SbVec3f>(V3);
+        // the nodes, triangles and polylines of the owned edges are laid out per chunk, so
+        // every chunk covers one range of the face nodes; each polyline is followed by its
+        // end marker and edges without a polyline take no room
+        std::vector<int> lineOffsets(edgeMap.Extent() + 1, -1);
+        for (int c = 0; c < static_cast<int>(chunks.size()); c++) {
+            Chunk& chunk = chunks[c];
+            chunk.nodeOffset = numNodes;
+            for (int f : chunk.faces) {
+                FaceMesh& faceMesh = faceMeshes[f];
+                faceMesh.chunk = c;
+                faceMesh.nodeOffset = numNodes;
+                faceMesh.triangleOffset = chunk.numTriangles;
+                numNodes += faceMesh.mesh->NbNodes();
+                chunk.numTriangles += faceMesh.mesh->NbTriangles();
+                for (const auto& edge : faceMesh.edges) {
+                    if (edge.second->NbNodes() > 0) {
+                        lineOffsets[edge.first] = chunk.numLines;
+                        chunk.numLines += edge.second->NbNodes() + 1;
+                        chunk.numPolylines++;
+                    }
+                }
+            }
+            chunk.numNodes = numNodes - chunk.nodeOffset;
+        }
+        const int numFaceNodes = numNodes;
 
-                // set the index vector with the 3 point indexes and the end delimiter
-                index[faceTriaOffset * 4 + 4 * (g - 1)] = faceNodeOffset + N1 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 1] = faceNodeOffset + N2 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 2] = faceNodeOffset + N3 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 3] = SO_END_FACE_INDEX;
+        // handling of the free edges that are not associated to a face; they are drawn by
+        // one line set that is never culled
+        std::vector<FreeEdge> freeEdges;
+        int numFreeNodes = 0, numFreeLines = 0;
+        for (int i = 1; i <= edgeMap.Extent(); i++) {
+            if (!faceEdges[i]) {
+                const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap.FindKey(i));
+                FreeEdge freeEdge;
+                freeEdge.edgeIndex = i;
+                freeEdge.polygon = ViewTool::polygonOfEdge(aEdge, freeEdge.location);
+                if (!freeEdge.polygon.IsNull() && freeEdge.polygon->NbNodes() > 0) {
+                    lineOffsets[i] = numFreeLines;
+                    numFreeNodes += freeEdge.polygon->NbNodes();
+                    numFreeLines += freeEdge.polygon->NbNodes() + 1;
+                    freeEdges.push_back(freeEdge);
+                }
             }
+        }
 
-            //parts[ii] = nbTriInFace;  // new part
+        // handling of the vertices
+        TopTools_IndexedMapOfShape vertexMap;
+        TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
 
-            // handling the edges lying on this face
-            TopExp_Explorer Exp;
-            for (Exp.Init(actFace, TopAbs_EDGE); Exp.More(); Exp.Next()) {
-                const TopoDS_Edge& curEdge = TopoDS::Edge(Exp.Current());
-                // get the overall index of this edge
-                int edgeIndex = edgeMap.FindIndex(curEdge);
-                edgeVector.push_back((int32_t)edgeIndex - 1);
-                // already processed this index ?
-                if (edgeIdxSet.find(edgeIndex) != edgeIdxSet.end()) {
-
-                    // this holds the indices of the edge's triangulation to the current polygon
-                    Handle(Poly_PolygonOnTriangulation) aPoly = 
-                        BRep_Tool::PolygonOnTriangulation(curEdge, mesh, aLoc);
-                    if (aPoly.IsNull()) {
-                        continue;  // polygon does not exist
-                    }
+        // with indexed face sets the face nodes lead the shared coordinates, followed by the
+        // nodes of the free edges and the vertices; triangle buffers carry their own nodes,
+        // so the shared coordinates only hold the free edges and vertices
+        const int pointOffset = triangleBuffers ? 0 : numFaceNodes;
 
-                    // getting the indexes of the edge polygon
-                    const TColStd_Array1OfInteger& indices = aPoly->Nodes();
-                    for (Standard_Integer i = indices.Lower(); i <= indices.Upper(); i++) {
-                        int nodeIndex = indices(i);
-                        int index = faceNodeOffset + nodeIndex - 1;
-                        lineSetMap[edgeIndex].push_back(index);
-
-                        // usually the coordinates for this edge are already set by the
-                        // triangles of the face this edge belongs to. However, there are
-                        // rare cases where some points are only referenced by the polygon
-                        // but not by any triangle. Thus, we must apply the coordinates to
-                        // make sure that everything is properly set.
-
-                        gp_Pnt p(mesh->Node(nodeIndex));
-                        if (!identity) {
-                            p.Transform(myTransf);
-                        }
-                        verts[index] = Base::convertTo<SbVec3f>(p);
-                    }
+        SoCoordinate3* coords = new SoCoordinate3;
+        SoIndexedLineSet* freeLineSet = new SoIndexedLineSet;
+        SoPointSet* pointSet = new SoPointSet;
 
-                    // remove the handled edge index from the set
-                    edgeIdxSet.erase(edgeIndex);
-                }
-            }
+        // create memory for the nodes and indexes
+        coords->point.setNum(pointOffset + numFreeNodes + vertexMap.Extent());
+        freeLineSet->coordIndex.setNum(numFreeLines);
 
-            edgeVector.push_back(-1);
+        // get the raw memory for fast fill up
+        SbVec3f* points = coords->point.startEditing();
+        int32_t* freeLines = freeLineSet->coordIndex.startEditing();
+
+        SoNormal* norm = nullptr;
+        SoNormalBinding* normalBinding = nullptr;
+        std::vector<SbVec3f> faceVerts, faceNorms;
+        SbVec3f* verts = points;
+        SbVec3f* norms = nullptr;
+        if (triangleBuffers) {
+            faceVerts.resize(numFaceNodes);
+            faceNorms.resize(numFaceNodes);
+            verts = faceVerts.data();
+            norms = faceNorms.data();
+        }
+        else {
+            norm = new SoNormal;
+            normalBinding = new SoNormalBinding;
+            norm->vector.setNum(numFaceNodes);
+            norms = norm->vector.startEditing();
+        }
 
-            // counting up the per Face offsets
-            faceNodeOffset += nbNodesInFace;
-            faceTriaOffset += nbTriInFace;
+        // indexed face sets are written in place; for triangle buffers the same layout is
+        // written to scratch buffers and converted per chunk afterwards
+        std::vector<SoIndexedFaceSet*> faceSets(chunks.size(), nullptr);
+        std::vector<SoIndexedLineSet*> lineSets(chunks.size(), nullptr);
+        std::vector<std::vector<int32_t>> scratchIndex(triangleBuffers ? chunks.size() : 0);
+        std::vector<std::vector<int32_t>> scratchLines(triangleBuffers ? chunks.size() : 0);
+        std::vector<int32_t*> chunkIndex(chunks.size(), nullptr);
+        std::vector<int32_t*> chunkLines(chunks.size(), nullptr);
+        for (size_t c = 0; c < chunks.size(); c++) {
+            if (triangleBuffers) {
+                scratchIndex[c].resize(static_cast<size_t>(chunks[c].numTriangles) * 4);
+                scratchLines[c].resize(chunks[c].numLines);
+                chunkIndex[c] = scratchIndex[c].data();
+                chunkLines[c] = scratchLines[c].data();
+                continue;
+            }
+
+            faceSets[c] = new SoIndexedFaceSet;
+            faceSets[c]->coordIndex.setNum(chunks[c].numTriangles * 4);
+            chunkIndex[c] = faceSets[c]->coordIndex.startEditing();
+            if (chunks[c].numLines > 0) {
+                lineSets[c] = new SoIndexedLineSet;
+                lineSets[c]->coordIndex.setNum(chunks[c].numLines);
+                chunkLines[c] = lineSets[c]->coordIndex.startEditing();
+            }
         }
 
+        // faces write disjoint ranges of the buffers
+        OSD_Parallel::For(0, faceMap.Extent(), [&](int i) {
+            const FaceMesh& faceMesh = faceMeshes[i];
+            if (!faceMesh.mesh.IsNull()) {
+                fillFace(TopoDS::Face(faceMap(i + 1)), faceMesh, verts, norms,
+                    chunkIndex[faceMesh.chunk], chunkLines[faceMesh.chunk], lineOffsets);
+            }
+        });
+
         // handling of the free edges
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            Standard_Boolean identity = true;
+        int nodeOffset = pointOffset;
+        for (const FreeEdge& freeEdge : freeEdges) {
             gp_Trsf myTransf;
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            int hash = Jumpers::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = ViewTool::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    if (!aLoc.IsIdentity()) {
-                        identity = false;
-                        myTransf = aLoc.Transformation();
-                    }
+            Standard_Boolean identity = freeEdge.location.IsIdentity();
+            if (!identity) {
+                myTransf = freeEdge.location.Transformation();
+            }
 
-                    const TColgp_Array1OfPnt& aNodes = aPoly->Nodes();
-                    int nbNodesInEdge = aPoly->NbNodes();
-
-                    gp_Pnt pnt;
-                    for (Standard_Integer j = 1; j <= nbNodesInEdge; j++) {
-                        pnt = aNodes(j);
-                        if (!identity) {
-                            pnt.Transform(myTransf);
-                        }
-                        int index = faceNodeOffset + j - 1;
-                        verts[index] = Base::convertTo<SbVec3f>(pnt);
-                        lineSetMap[i].push_back(index);
-                    }
+            const TColgp_Array1OfPnt& aNodes = freeEdge.polygon->Nodes();
+            int nbNodesInEdge = freeEdge.polygon->NbNodes();
 
-                    faceNodeOffset += nbNodesInEdge;
+            int32_t* lineCoords = freeLines + lineOffsets[freeEdge.edgeIndex];
+            gp_Pnt pnt;
+            for (Standard_Integer j = 1; j <= nbNodesInEdge; j++) {
+                pnt = aNodes(j);
+                if (!identity) {
+                    pnt.Transform(myTransf);
                 }
+                int coordIndex = nodeOffset + j - 1;
+                points[coordIndex] = Base::convertTo<SbVec3f>(pnt);
+                *lineCoords++ = coordIndex;
             }
+            *lineCoords = -1;
+
+            nodeOffset += nbNodesInEdge;
         }
 
-        pointSet->startIndex.setValue(faceNodeOffset);
+        pointSet->startIndex.setValue(nodeOffset);
         for (int i = 0; i < vertexMap.Extent(); i++) {
             const TopoDS_Vertex& aVertex = TopoDS::Vertex(vertexMap(i + 1));
             gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
 
-            verts[faceNodeOffset + i] = Base::convertTo<SbVec3f>(pnt);
+            points[nodeOffset + i] = Base::convertTo<SbVec3f>(pnt);
         }
 
-        // normalize all normals
-        for (int i = 0; i < numNorms; i++) {
-            norms[i].normalize();
+        // end the editing of the nodes
+        coords->point.finishEditing();
+        freeLineSet->coordIndex.finishEditing();
+        if (norm) {
+            norm->vector.finishEditing();
         }
-
-        std::vector<int32_t> lineSetCoords;
-        for (const auto& it : lineSetMap) {
-            lineSetCoords.insert(lineSetCoords.end(), it.second.begin(), it.second.end());
-            lineSetCoords.push_back(-1);
+        for (size_t c = 0; c < chunks.size(); c++) {
+            if (faceSets[c]) {
+                faceSets[c]->coordIndex.finishEditing();
+            }
+            if (lineSets[c]) {
+                lineSets[c]->coordIndex.finishEditing();
+            }
         }
 
-        // preset the index vector size
-        numLines = lineSetCoords.size();
-        lineSet->coordIndex.setNum(numLines);
-        int32_t* lines = lineSet->coordIndex.startEditing();
-
-        int l = 0;
-        for (auto it = lineSetCoords.begin(); it != lineSetCoords.end(); ++it, l++) {
-            lines[l] = *it;
+        std::vector<SoNode*> chunkFaces(chunks.size(), nullptr);
+        std::vector<SoNode*> chunkEdges(chunks.size(), nullptr);
+        if (triangleBuffers) {
+            buildTriangleBuffers(chunks, faceVerts, faceNorms, scratchIndex, scratchLines, chunkFaces, chunkEdges);
+        }
+        else {
+            chunkFaces.assign(faceSets.begin(), faceSets.end());
+            chunkEdges.assign(lineSets.begin(), lineSets.end());
         }
 
-        // end the editing of the nodes
-        coords->point.finishEditing();
-        norm->vector.finishEditing();
-        faceSet->coordIndex.finishEditing();
-        //faceSet->partIndex.finishEditing();
-        lineSet->coordIndex.finishEditing();
-
-        SoMaterial* material = new SoMaterial;
-        material->diffuseColor.setValue(color);
-        material->specularColor.setValue(1.0, 1.0, 1.0);
-        material->shininess.setValue(0.5);
-
-        shapeSep->addChild(material);
-        shapeSep->addChild(normalBinding);
-        shapeSep->addChild(norm);
+        // the chunks share the coordinates and normals; with render statistics a callback in
+        // front of each chunk counts it before the culling separator is entered
+        if (norm) {
+            shapeSep->addChild(normalBinding);
+            shapeSep->addChild(norm);
+        }
         shapeSep->addChild(coords);
-        shapeSep->addChild(faceSet);
-        shapeSep->addChild(lineSet);
+        for (size_t c = 0; c < chunks.size(); c++) {
+            if (counted) {
+                SoCallback* met = new SoCallback;
+                met->setCallback(chunkMetCallback, reinterpret_cast<void*>(static_cast<intptr_t>(chunks[c].numTriangles)));
+                shapeSep->addChild(met);
+            }
+            shapeSep->addChild(makeChunkNode(chunkFaces[c], chunkEdges[c], chunks[c].numTriangles, minScreenArea, counted));
+        }
+        shapeSep->addChild(freeLineSet);
         shapeSep->addChild(pointSet);
         return shapeSep;
 
@@ -480,4 +1076,4 @@ SoNode* ShapeUtil::convertSingleShape(TopoDS_Shape shape, double deviation, doub
         //spdlog::error("Unknown error during shape conversion");
         return nullptr;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,221 @@
+#include "SoInterleavedTriangleSet.h"
+
+#include <Inventor/actions/SoGLRenderAction.h>
+#include <Inventor/bundles/SoMaterialBundle.h>
+#include <Inventor/details/SoFaceDetail.h>
+#include <Inventor/elements/SoGLCacheContextElement.h>
+#include <Inventor/SoPrimitiveVertex.h>
+#include <Inventor/C/glue/gl.h>
+#include <Inventor/system/gl.h>
+
+#include <utility>
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+namespace {
+    // Floats per vertex and the byte offset of the position behind the normal
+    const int VERTEX_FLOATS = 6;
+    const size_t POSITION_OFFSET = 3 * sizeof(float);
+
+    // Vertex count up to which 16-bit indexes are used
+    const size_t MAX_SHORT_VERTICES = 65536;
+
+    // Buffers to delete once their GL context is current again
+    struct BufferDeletion {
+        GLuint buffers[2];
+    };
+
+    void deleteBuffers(void* closure, uint32_t context)
+    {
+        BufferDeletion* deletion = static_cast<BufferDeletion*>(closure);
+        const cc_glglue* glue = cc_glglue_instance(static_cast<int>(context));
+        cc_glglue_glDeleteBuffers(glue, 2, deletion->buffers);
+        delete deletion;
+    }
+}
+
+SO_NODE_SOURCE(SoInterleavedTriangleSet);
+
+void SoInterleavedTriangleSet::initClass()
+{
+    if (getClassTypeId() == SoType::badType()) {
+        SO_NODE_INIT_CLASS(SoInterleavedTriangleSet, SoShape, "Shape");
+    }
+}
+
+SoInterleavedTriangleSet::SoInterleavedTriangleSet()
+    : m_numIndices(0)
+{
+    SO_NODE_CONSTRUCTOR(SoInterleavedTriangleSet);
+}
+
+SoInterleavedTriangleSet::~SoInterleavedTriangleSet()
+{
+    releaseBuffers();
+}
+
+void SoInterleavedTriangleSet::setGeometry(std::vector<float> vertices, const std::vector<uint32_t>& indices)
+{
+    releaseBuffers();
+
+    m_vertices = std::move(vertices);
+    m_numIndices = static_cast<int>(indices.size());
+    m_shortIndices.clear();
+    m_indices.clear();
+    if (m_vertices.size() / VERTEX_FLOATS <= MAX_SHORT_VERTICES) {
+        m_shortIndices.assign(indices.begin(), indices.end());
+    }
+    else {
+        m_indices = indices;
+    }
+
+    m_box.makeEmpty();
+    for (size_t i = 0; i + VERTEX_FLOATS <= m_vertices.size(); i += VERTEX_FLOATS) {
+        m_box.extendBy(SbVec3f(m_vertices[i + 3], m_vertices[i + 4], m_vertices[i + 5]));
+    }
+
+    touch();
+}
+
+void SoInterleavedTriangleSet::copyContents(const SoFieldContainer* from, SbBool copyConnections)
+{
+    SoShape::copyContents(from, copyConnections);
+
+    const SoInterleavedTriangleSet* source = static_cast<const SoInterleavedTriangleSet*>(from);
+    releaseBuffers();
+    m_vertices = source->m_vertices;
+    m_shortIndices = source->m_shortIndices;
+    m_indices = source->m_indices;
+    m_numIndices = source->m_numIndices;
+    m_box = source->m_box;
+}
+
+size_t SoInterleavedTriangleSet::getMemoryUsage() const
+{
+    return m_vertices.size() * sizeof(float)
+        + m_shortIndices.size() * sizeof(uint16_t)
+        + m_indices.size() * sizeof(uint32_t);
+}
+
+uint32_t SoInterleavedTriangleSet::vertexIndex(int i) const
+{
+    return m_shortIndices.empty() ? m_indices[i] : m_shortIndices[i];
+}
+
+void SoInterleavedTriangleSet::releaseBuffers()
+{
+    // Buffer objects can only be deleted with their context current, which Coin arranges
+    for (const ContextBuffers& buffers : m_buffers) {
+        BufferDeletion* deletion = new BufferDeletion;
+        deletion->buffers[0] = buffers.vertexBuffer;
+        deletion->buffers[1] = buffers.indexBuffer;
+        SoGLCacheContextElement::scheduleDeleteCallback(buffers.context, deleteBuffers, deletion);
+    }
+    m_buffers.clear();
+}
+
+void SoInterleavedTriangleSet::GLRender(SoGLRenderAction* action)
+{
+    if (m_numIndices == 0 || !shouldGLRender(action)) {
+        return;
+    }
+
+    SoMaterialBundle mb(action);
+    mb.sendFirst();
+
+    const uint32_t context = action->getCacheContext();
+    const cc_glglue* glue = cc_glglue_instance(static_cast<int>(context));
+    const GLsizei stride = VERTEX_FLOATS * sizeof(float);
+    const GLenum indexType = m_shortIndices.empty() ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    const void* indexData = m_shortIndices.empty() ? static_cast<const void*>(m_indices.data())
+                                                   : static_cast<const void*>(m_shortIndices.data());
+
+    if (!cc_glglue_has_vertex_array(glue)) {
+        glBegin(GL_TRIANGLES);
+        for (int i = 0; i < m_numIndices; i++) {
+            const float* vertex = &m_vertices[static_cast<size_t>(vertexIndex(i)) * VERTEX_FLOATS];
+            glNormal3fv(vertex);
+            glVertex3fv(vertex + 3);
+        }
+        glEnd();
+        return;
+    }
+
+    // The arrays are uploaded on the first draw in a context; afterwards the pointers
+    // below are offsets into the bound buffers
+    const char* vertexBase = reinterpret_cast<const char*>(m_vertices.data());
+    const bool useBuffers = cc_glglue_has_vertex_buffer_object(glue);
+    if (useBuffers) {
+        auto it = m_buffers.begin();
+        while (it != m_buffers.end() && it->context != context) {
+            ++it;
+        }
+
+        if (it == m_buffers.end()) {
+            GLuint ids[2];
+            cc_glglue_glGenBuffers(glue, 2, ids);
+            cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, ids[0]);
+            cc_glglue_glBufferData(glue, GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), m_vertices.data(), GL_STATIC_DRAW);
+            cc_glglue_glBindBuffer(glue, GL_ELEMENT_ARRAY_BUFFER, ids[1]);
+            const size_t indexBytes = m_shortIndices.empty() ? m_indices.size() * sizeof(uint32_t)
+                                                             : m_shortIndices.size() * sizeof(uint16_t);
+            cc_glglue_glBufferData(glue, GL_ELEMENT_ARRAY_BUFFER, indexBytes, indexData, GL_STATIC_DRAW);
+            m_buffers.push_back({ context, ids[0], ids[1] });
+        }
+        else {
+            cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, it->vertexBuffer);
+            cc_glglue_glBindBuffer(glue, GL_ELEMENT_ARRAY_BUFFER, it->indexBuffer);
+        }
+        vertexBase = nullptr;
+        indexData = nullptr;
+    }
+
+    cc_glglue_glEnableClientState(glue, GL_NORMAL_ARRAY);
+    cc_glglue_glEnableClientState(glue, GL_VERTEX_ARRAY);
+    cc_glglue_glNormalPointer(glue, GL_FLOAT, stride, vertexBase);
+    cc_glglue_glVertexPointer(glue, 3, GL_FLOAT, stride, vertexBase + POSITION_OFFSET);
+
+    cc_glglue_glDrawElements(glue, GL_TRIANGLES, m_numIndices, indexType, indexData);
+
+    cc_glglue_glDisableClientState(glue, GL_VERTEX_ARRAY);
+    cc_glglue_glDisableClientState(glue, GL_NORMAL_ARRAY);
+    if (useBuffers) {
+        cc_glglue_glBindBuffer(glue, GL_ARRAY_BUFFER, 0);
+        cc_glglue_glBindBuffer(glue, GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+}
+
+void SoInterleavedTriangleSet::computeBBox(SoAction*, SbBox3f& box, SbVec3f& center)
+{
+    box = m_box;
+    if (!box.isEmpty()) {
+        center = box.getCenter();
+    }
+}
+
+void SoInterleavedTriangleSet::generatePrimitives(SoAction* action)
+{
+    SoPrimitiveVertex pv;
+    SoFaceDetail faceDetail;
+    pv.setDetail(&faceDetail);
+
+    beginShape(action, TRIANGLES, &faceDetail);
+    for (int i = 0; i < m_numIndices; i++) {
+        if (i % 3 == 0) {
+            faceDetail.setFaceIndex(i / 3);
+        }
+        const float* vertex = &m_vertices[static_cast<size_t>(vertexIndex(i)) * VERTEX_FLOATS];
+        pv.setNormal(SbVec3f(vertex[0], vertex[1], vertex[2]));
+        pv.setPoint(SbVec3f(vertex[3], vertex[4], vertex[5]));
+        shapeVertex(&pv);
+    }
+    endShape();
+}
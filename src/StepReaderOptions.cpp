@@ -0,0 +1,64 @@
+#include "StepReaderOptions.h"
+
+#include <Standard_Version.hxx>
+
+#if OCC_VERSION_HEX >= 0x070900
+#include <DESTEP_Parameters.hxx>
+typedef DESTEP_Parameters StepReadParameters;
+#elif OCC_VERSION_HEX >= 0x070800
+#include <StepData_ConfParameters.hxx>
+typedef StepData_ConfParameters StepReadParameters;
+#else
+#include <Interface_Static.hxx>
+#include <mutex>
+#endif
+
+IFSelect_ReturnStatus StepReaderOptions::ReadFile(STEPControl_Reader& reader, const std::string& filePath) const
+{
+#if OCC_VERSION_HEX >= 0x070800
+    // Start from the process-wide defaults and override per reader; the parameters
+    // are stored in the reader's model and used by its transfer
+    StepReadParameters params;
+    params.InitFromStatic();
+
+    if (maxPrecision) {
+        params.ReadMaxPrecisionVal = *maxPrecision;
+    }
+    if (productMode) {
+        params.ReadProductMode = *productMode;
+    }
+    if (nonManifold) {
+        params.ReadNonmanifold = *nonManifold;
+    }
+    if (shapeRepresentation) {
+        params.ReadShapeRepr = static_cast<StepReadParameters::ReadMode_ShapeRepr>(*shapeRepresentation);
+    }
+    if (surfaceCurveMode) {
+        params.ReadSurfaceCurveMode = static_cast<StepReadParameters::ReadMode_SurfaceCurve>(*surfaceCurveMode);
+    }
+
+    return reader.ReadFile(filePath.c_str(), params);
+#else
+    // No per-model parameters before OCCT 7.8: serialize the global writes
+    static std::mutex staticsMutex;
+    std::lock_guard<std::mutex> lock(staticsMutex);
+
+    if (maxPrecision) {
+        Interface_Static::SetRVal("read.maxprecision.val", *maxPrecision);
+    }
+    if (productMode) {
+        Interface_Static::SetIVal("read.step.product.mode", *productMode ? 1 : 0);
+    }
+    if (nonManifold) {
+        Interface_Static::SetIVal("read.step.nonmanifold", *nonManifold ? 1 : 0);
+    }
+    if (shapeRepresentation) {
+        Interface_Static::SetIVal("read.step.shape.repr", *shapeRepresentation);
+    }
+    if (surfaceCurveMode) {
+        Interface_Static::SetIVal("read.surfacecurve.mode", *surfaceCurveMode);
+    }
+
+    return reader.ReadFile(filePath.c_str());
+#endif
+}
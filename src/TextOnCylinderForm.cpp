@@ -87,6 +87,7 @@
 #include <BRepBuilderAPI_MakeWire.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
 #include <BRepFilletAPI_MakeFillet.hxx>
 #include <BRepOffsetAPI_MakeOffset.hxx>
 #include <BRepAlgoAPI_Fuse.hxx>
@@ -112,6 +113,8 @@
 #include <TCollection_AsciiString.hxx>
 
 #include "ViewTool.h"
+#include "ShapeUtil.h"
+#include "BackgroundShapeConverter.h"
 #include "base.h"
 #include "TextShape.h"
 
@@ -142,13 +145,18 @@ TextOnCylinderForm::TextOnCylinderForm(QWidget *parent)
       m_zoomAllBtn(nullptr),
       m_textColor(Qt::blue),
       m_cylinderCreated(false),
-      m_textCreated(false)
+      m_textCreated(false),
+      m_converter(nullptr)
 {
+    m_converter = new BackgroundShapeConverter(this);
     setupUI();
 }
 
 TextOnCylinderForm::~TextOnCylinderForm()
 {
+    // Stop the conversion before the scene it feeds goes away
+    delete m_converter;
+
     // Cleanup Coin3D nodes
     if (m_root) {
         m_root->unref();
@@ -498,636 +506,51 @@ TopoDS_Shape TextOnCylinderForm::engraveTextOntoCylinder(const TopoDS_Shape& cyl
     return cutter.Shape();
 }
 
-SoNode* TextOnCylinderForm::convertShapeRecursive(TopoDS_Shape shape, double deviation, double angularDeflection, SbColor color)
+bool TextOnCylinderForm::displayShape(const TopoDS_Shape& shape, bool clearExisting, SbColor color)
 {
-    try
-    {
-        SoSeparator* shapeSep = new SoSeparator;
-        SoCoordinate3* coords = new SoCoordinate3;
-        coords->ref();
-        SoNormal* norm = new SoNormal;
-        norm->ref();
-        SoNormalBinding* normalBinding = new SoNormalBinding;
-        normalBinding->ref();
-        SoIndexedFaceSet* faceSet = new SoIndexedFaceSet;
-        faceSet->ref();
-        SoIndexedLineSet* lineSet = new SoIndexedLineSet;
-        lineSet->ref();
-        SoPointSet* pointSet = new SoPointSet;
-        pointSet->ref();
-
-        if (ViewTool::isShapeEmpty(shape)) {
-            coords->point.setNum(0);
-            norm->vector.setNum(0);
-            faceSet->coordIndex.setNum(0);
-            lineSet->coordIndex.setNum(0);
-            pointSet->startIndex.setValue(0);
-            return shapeSep;
-        }
-
-        int numTriangles = 0, numNodes = 0, numNorms = 0, numFaces = 0, numEdges = 0, numLines = 0;
-
-        std::set<int> faceEdges;
-
-        Standard_Real deflection = ViewTool::getDeflection(shape, deviation);
-
-        if (deflection < gp::Resolution()) {
-            deflection = Precision::Confusion();
-        }
-
-
-        Standard_Real AngDeflectionRads = angularDeflection;
-
-        IMeshTools_Parameters meshParams;
-        meshParams.Deflection = deflection;
-        meshParams.Relative = Standard_False;
-        meshParams.Angle = AngDeflectionRads;
-        meshParams.InParallel = Standard_True;
-        meshParams.AllowQualityDecrease = Standard_True;
-
-        BRepMesh_IncrementalMesh importMesh(shape, meshParams);
-
-
-        TopLoc_Location aLoc;
-        shape.Location(aLoc);
-
-        // count triangles and nodes in the mesh
-        TopTools_IndexedMapOfShape faceMap;
-        TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
-        for (int i = 1; i <= faceMap.Extent(); i++) {
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(faceMap(i)), aLoc);
-
-            if (mesh.IsNull()) {
-                mesh = ViewTool::triangulationOfFace(TopoDS::Face(faceMap(i)));
-            }
-
-            // Note: we must also count empty faces
-            if (!mesh.IsNull()) {
-                numTriangles += mesh->NbTriangles();
-                numNodes += mesh->NbNodes();
-                numNorms += mesh->NbNodes();
-            }
-
-            TopExp_Explorer xp;
-            for (xp.Init(faceMap(i), TopAbs_EDGE); xp.More(); xp.Next()) {
-                faceEdges.insert(Jumpers::ShapeMapHasher{}(xp.Current()));
-            }
-            numFaces++;
-        }
-
-        // get an indexed map of edges
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
-
-        // key is the edge number, value the coord indexes. This is needed to keep the same order as
-        // the edges.
-        std::map<int, std::vector<int32_t>> lineSetMap;
-        std::set<int> edgeIdxSet;
-        std::vector<int32_t> edgeVector;
-
-        // count and index the edges
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            edgeIdxSet.insert(i);
-            numEdges++;
-
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            TopLoc_Location aLoc;
-
-
-            int hash = Jumpers::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = ViewTool::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    int nbNodesInEdge = aPoly->NbNodes();
-                    numNodes += nbNodesInEdge;
-                }
-            }
-        }
-
-        // handling of the vertices
-        TopTools_IndexedMapOfShape vertexMap;
-        TopExp::MapShapes(shape, TopAbs_VERTEX, vertexMap);
-        numNodes += vertexMap.Extent();
-
-        // create memory for the nodes and indexes
-        coords->point.setNum(numNodes);
-        norm->vector.setNum(numNorms);
-        faceSet->coordIndex.setNum(numTriangles * 4);
-
-        // get the raw memory for fast fill up
-        SbVec3f* verts = coords->point.startEditing();
-        SbVec3f* norms = norm->vector.startEditing();
-        int32_t* index = faceSet->coordIndex.startEditing();
-
-         // preset the normal vector with null vector
-        for (int i = 0; i < numNorms; i++) {
-            norms[i] = SbVec3f(0.0, 0.0, 0.0);
-        }
-
-        int ii = 0, faceNodeOffset = 0, faceTriaOffset = 0;
-        for (int i = 1; i <= faceMap.Extent(); i++, ii++) {
-            TopLoc_Location aLoc;
-            const TopoDS_Face& actFace = TopoDS::Face(faceMap(i));
-            // get the mesh of the shape
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace, aLoc);
-            if (mesh.IsNull()) {
-                mesh = ViewTool::triangulationOfFace(actFace);
-                continue;
-            }
-
-            // getting the transformation of the shape/face
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!aLoc.IsIdentity()) {
-                identity = false;
-                myTransf = aLoc.Transformation();
-            }
-
-            // getting size of node and triangle array of this face
-            int nbNodesInFace = mesh->NbNodes();
-            int nbTriInFace = mesh->NbTriangles();
-            // check orientation
-            TopAbs_Orientation orient = actFace.Orientation();
-
-            int numNodes = mesh->NbNodes();
-            TColgp_Array1OfDir Normals(1, numNodes);
-
-            for (int g = 1; g <= nbTriInFace; g++) {
-                // Get the triangle
-                Standard_Integer N1, N2, N3;
-                mesh->Triangle(g).Get(N1, N2, N3);
-
-                // change orientation of the triangle if the face is reversed
-                if (orient != TopAbs_FORWARD) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
-
-
-                gp_Pnt V1(mesh->Node(N1)), V2(mesh->Node(N2)), V3(mesh->Node(N3));
-
-                // get the 3 normals of this triangle
-                gp_Vec NV1, NV2, NV3;
-
-                gp_Vec v1 = Base::convertTo<gp_Vec>(V1);
-                gp_Vec v2 = Base::convertTo<gp_Vec>(V2);
-                gp_Vec v3 = Base::convertTo<gp_Vec>(V3);
-
-                gp_Vec normal = (v2 - v1) ^ (v3 - v1);
-                NV1 = normal;
-                NV2 = normal;
-                NV3 = normal;
-
-                // transform the vertices and normals to the place of the face
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                }
-
-                // add the normals for all points of this triangle
-                norms[faceNodeOffset + N1 - 1] += Base::convertTo<SbVec3f>(NV1);
-                norms[faceNodeOffset + N2 - 1] += Base::convertTo<SbVec3f>(NV2);
-                norms[faceNodeOffset + N3 - 1] += Base::convertTo<SbVec3f>(NV3);
-
-                // set the vertices
-                verts[faceNodeOffset + N1 - 1] = Base::convertTo<SbVec3f>(V1);
-                verts[faceNodeOffset + N2 - 1] = Base::convertTo<SbVec3f>(V2);
-                verts[faceNodeOffset + N3 - 1] = Base::convertTo<SbVec3f>(V3);
-
-                // set the index vector with the 3 point indexes and the end delimiter
-                index[faceTriaOffset * 4 + 4 * (g - 1)] = faceNodeOffset + N1 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 1] = faceNodeOffset + N2 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 2] = faceNodeOffset + N3 - 1;
-                index[faceTriaOffset * 4 + 4 * (g - 1) + 3] = SO_END_FACE_INDEX;
-            }
-
-            // handling the edges lying on this face
-            TopExp_Explorer Exp;
-            for (Exp.Init(actFace, TopAbs_EDGE); Exp.More(); Exp.Next()) {
-                const TopoDS_Edge& curEdge = TopoDS::Edge(Exp.Current());
-                // get the overall index of this edge
-                int edgeIndex = edgeMap.FindIndex(curEdge);
-                edgeVector.push_back((int32_t)edgeIndex - 1);
-                // already processed this index ?
-                if (edgeIdxSet.find(edgeIndex) != edgeIdxSet.end()) {
-
-                    // this holds the indices of the edge's triangulation to the current polygon
-                    Handle(Poly_PolygonOnTriangulation) aPoly =
-                        BRep_Tool::PolygonOnTriangulation(curEdge, mesh, aLoc);
-                    if (aPoly.IsNull()) {
-                        continue;  // polygon does not exist
-                    }
-
-                    // getting the indexes of the edge polygon
-                    const TColStd_Array1OfInteger& indices = aPoly->Nodes();
-                    for (Standard_Integer i = indices.Lower(); i <= indices.Upper(); i++) {
-                        int nodeIndex = indices(i);
-                        int index = faceNodeOffset + nodeIndex - 1;
-                        lineSetMap[edgeIndex].push_back(index);
-
-                        // usually the coordinates for this edge are already set by the
-                        // triangles of the face this edge belongs to. However, there are
-                        // rare cases where some points are only referenced by the polygon
-                        // but not by any triangle. Thus, we must apply the coordinates to
-                        // make sure that everything is properly set.
-
-                        gp_Pnt p(mesh->Node(nodeIndex));
-                        if (!identity) {
-                            p.Transform(myTransf);
-                        }
-                        verts[index] = Base::convertTo<SbVec3f>(p);
-                    }
-
-                    // remove the handled edge index from the set
-                    edgeIdxSet.erase(edgeIndex);
-                }
-            }
-
-            edgeVector.push_back(-1);
-
-            // counting up the per Face offsets
-            faceNodeOffset += nbNodesInFace;
-            faceTriaOffset += nbTriInFace;
-        }
-
-        // handling of the free edges
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            Standard_Boolean identity = true;
-            gp_Trsf myTransf;
-            TopLoc_Location aLoc;
-
-            // handling of the free edge that are not associated to a face
-            int hash = Jumpers::ShapeMapHasher{}(aEdge);
-            if (faceEdges.find(hash) == faceEdges.end()) {
-                Handle(Poly_Polygon3D) aPoly = ViewTool::polygonOfEdge(aEdge, aLoc);
-                if (!aPoly.IsNull()) {
-                    if (!aLoc.IsIdentity()) {
-                        identity = false;
-                        myTransf = aLoc.Transformation();
-                    }
-
-                    const TColgp_Array1OfPnt& aNodes = aPoly->Nodes();
-                    int nbNodesInEdge = aPoly->NbNodes();
-
-                    gp_Pnt pnt;
-                    for (Standard_Integer j = 1; j <= nbNodesInEdge; j++) {
-                        pnt = aNodes(j);
-                        if (!identity) {
-                            pnt.Transform(myTransf);
-                        }
-                        int index = faceNodeOffset + j - 1;
-                        verts[index] = Base::convertTo<SbVec3f>(pnt);
-                        lineSetMap[i].push_back(index);
-                    }
-
-                    faceNodeOffset += nbNodesInEdge;
-                }
-            }
-        }
-
-        pointSet->startIndex.setValue(faceNodeOffset);
-        for (int i = 0; i < vertexMap.Extent(); i++) {
-            const TopoDS_Vertex& aVertex = TopoDS::Vertex(vertexMap(i + 1));
-            gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
-
-            verts[faceNodeOffset + i] = Base::convertTo<SbVec3f>(pnt);
-        }
-
-        // normalize all normals
-        for (int i = 0; i < numNorms; i++) {
-            norms[i].normalize();
-        }
-
-        std::vector<int32_t> lineSetCoords;
-        for (const auto& it : lineSetMap) {
-            lineSetCoords.insert(lineSetCoords.end(), it.second.begin(), it.second.end());
-            lineSetCoords.push_back(-1);
-        }
-
-        // preset the index vector size
-        numLines = lineSetCoords.size();
-        lineSet->coordIndex.setNum(numLines);
-        int32_t* lines = lineSet->coordIndex.startEditing();
-
-        int l = 0;
-        for (auto it = lineSetCoords.begin(); it != lineSetCoords.end(); ++it, l++) {
-            lines[l] = *it;
-        }
-
-        // end the editing of the nodes
-        coords->point.finishEditing();
-        norm->vector.finishEditing();
-        faceSet->coordIndex.finishEditing();
-        lineSet->coordIndex.finishEditing();
-
-        SoMaterial* material = new SoMaterial;
-        material->diffuseColor.setValue(color);
-        material->specularColor.setValue(1.0, 1.0, 1.0);
-        material->shininess.setValue(0.5);
-
-        shapeSep->addChild(material);
-        shapeSep->addChild(normalBinding);
-        shapeSep->addChild(norm);
-        shapeSep->addChild(coords);
-        shapeSep->addChild(faceSet);
-        shapeSep->addChild(lineSet);
-        shapeSep->addChild(pointSet);
-        return shapeSep;
-    }
-    catch (const Standard_Failure& e) {
-        QMessageBox::critical(this, "OCCT Exception", e.GetMessageString());
-        return nullptr;
+    // Clear existing model if requested; this also cancels conversions still running
+    if (clearExisting) {
+        clearScene();
     }
-    catch (...) {
-        QMessageBox::critical(this, "Error", "Unknown error during shape conversion");
-        return nullptr;
+
+    if (shape.IsNull()) {
+        return false;
     }
-}
 
-SoNode* TextOnCylinderForm::convertShapeToCoin3D(const TopoDS_Shape& shape)
-{
-    try {
-        SoSeparator* shapeSep = new SoSeparator;
-        
-        if (shape.IsNull()) {
-            return shapeSep;
-        }
-        
-        // Create mesh for the entire shape with appropriate resolution
-        Standard_Real deflection = 0.1; // Adjust this value for better quality vs performance
-        
-        // Since OCCT 7.6 a value of equal 0 is not allowed any more
-        if (deflection < gp::Resolution()) {
-            deflection = Precision::Confusion();
-        }
-        
-        // Create mesh parameters
-        IMeshTools_Parameters meshParams;
-        meshParams.Deflection = deflection;
-        meshParams.Relative = Standard_False;
-        meshParams.Angle = 0.5; // Angular deflection in radians
-        meshParams.InParallel = Standard_True;
-        meshParams.AllowQualityDecrease = Standard_True;
-        
-        // Generate mesh
-        BRepMesh_IncrementalMesh meshGenerator(shape, meshParams);
-        
-        // First pass: Calculate total number of nodes needed
-        TopTools_IndexedMapOfShape faceMap;
-        TopExp::MapShapes(shape, TopAbs_FACE, faceMap);
-        
-        int numTriangles = 0, numNodes = 0, numNorms = 0;
-        
-        TopLoc_Location aLoc = shape.Location();
-        
-        // Calculate nodes from faces
-        for (int i = 1; i <= faceMap.Extent(); i++) {
-            const TopoDS_Face& face = TopoDS::Face(faceMap(i));
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(face, aLoc);
-            
-            if (!mesh.IsNull()) {
-                numTriangles += mesh->NbTriangles();
-                numNodes += mesh->NbNodes();
-                numNorms += mesh->NbNodes();
-            }
+    // Convert OCCT shape to Coin3D node on the worker; shapes shown on top of each other
+    // are converted in the order they were requested. The worker meshes a copy of the
+    // topology, as the cylinder and the text are projected and cut on this thread meanwhile.
+    // The copy is new on every call, so it is converted without the tessellation cache.
+    BRepBuilderAPI_Copy copier(shape, Standard_False, Standard_False);
+    const TopoDS_Shape displayed = copier.Shape();
+
+    BackgroundShapeConverter::Callbacks callbacks;
+    callbacks.partReady = [this](SoNode* node, int, int) {
+        m_modelRoot->addChild(node);
+    };
+    callbacks.finished = [this](int converted, int) {
+        if (converted == 0) {
+            QMessageBox::critical(this, "Error", "Failed to convert shape for display");
+            return;
         }
-        
-        // Get edges
-        TopTools_IndexedMapOfShape edgeMap;
-        TopExp::MapShapes(shape, TopAbs_EDGE, edgeMap);
-        
-        // Calculate nodes from edges
-        int edgeNodes = 0;
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            
-            Standard_Real first, last;
-            Handle(Geom_Curve) curve = BRep_Tool::Curve(aEdge, first, last);
-            
-            if (!curve.IsNull()) {
-                GeomAdaptor_Curve curveAdaptor(curve);
-                GCPnts_TangentialDeflection discretizer;
-                discretizer.Initialize(curveAdaptor, 0.05, 0.05, first, last);
-                
-                edgeNodes += discretizer.NbPoints();
-            }
-        }
-        numNodes += edgeNodes;
-        
-        // Create Coin3D nodes with correct sizes
-        SoCoordinate3* coords = new SoCoordinate3;
-        SoNormal* norm = new SoNormal;
-        SoNormalBinding* normalBinding = new SoNormalBinding;
-        SoIndexedFaceSet* faceSet = new SoIndexedFaceSet;
-        SoIndexedLineSet* lineSet = new SoIndexedLineSet;
-        
-        normalBinding->value.setValue(SoNormalBinding::PER_VERTEX_INDEXED);
-        
-        // Allocate memory for nodes and indexes
-        coords->point.setNum(numNodes);
-        norm->vector.setNum(numNorms);
-        faceSet->coordIndex.setNum(numTriangles * 4); // 3 vertices + SO_END_FACE_INDEX
-        
-        // Get raw pointers for fast access
-        SbVec3f* verts = coords->point.startEditing();
-        SbVec3f* norms = norm->vector.startEditing();
-        int32_t* index = faceSet->coordIndex.startEditing();
-        
-        // Initialize normals to zero vector
-        for (int i = 0; i < numNorms; i++) {
-            norms[i] = SbVec3f(0.0, 0.0, 0.0);
-        }
-        
-        // Process faces (second pass)
-        int faceNodeOffset = 0, faceTriaOffset = 0;
-        
-        for (int i = 1; i <= faceMap.Extent(); i++) {
-            TopLoc_Location faceLoc;
-            const TopoDS_Face& actFace = TopoDS::Face(faceMap(i));
-            
-            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(actFace, faceLoc);
-            if (mesh.IsNull()) {
-                continue;
-            }
-            
-            // Get transformation
-            gp_Trsf myTransf;
-            Standard_Boolean identity = true;
-            if (!faceLoc.IsIdentity()) {
-                identity = false;
-                myTransf = faceLoc.Transformation();
-            }
-            
-            int nbNodesInFace = mesh->NbNodes();
-            int nbTriInFace = mesh->NbTriangles();
-            TopAbs_Orientation orient = actFace.Orientation();
-            
-            // Process triangles
-            for (int g = 1; g <= nbTriInFace; g++) {
-                Standard_Integer N1, N2, N3;
-                mesh->Triangle(g).Get(N1, N2, N3);
-                
-                // Adjust orientation if needed
-                if (orient != TopAbs_FORWARD) {
-                    Standard_Integer tmp = N1;
-                    N1 = N2;
-                    N2 = tmp;
-                }
-                
-                // Get vertices
-                gp_Pnt V1(mesh->Node(N1)), V2(mesh->Node(N2)), V3(mesh->Node(N3));
-                
-                // Apply transformation
-                if (!identity) {
-                    V1.Transform(myTransf);
-                    V2.Transform(myTransf);
-                    V3.Transform(myTransf);
-                }
-                
-                // Calculate normal
-                gp_Vec v1 = V2.XYZ() - V1.XYZ();
-                gp_Vec v2 = V3.XYZ() - V1.XYZ();
-                gp_Vec triangleNormal = v1 ^ v2;
-                
-                // Normalize if non-zero
-                if (triangleNormal.SquareMagnitude() > Precision::SquareConfusion()) {
-                    triangleNormal.Normalize();
-                } else {
-                    triangleNormal.SetXYZ(gp_XYZ(0.0, 0.0, 1.0));
-                }
-                
-                // Store vertex coordinates
-                int idx1 = faceNodeOffset + N1 - 1;
-                int idx2 = faceNodeOffset + N2 - 1;
-                int idx3 = faceNodeOffset + N3 - 1;
-                
-                verts[idx1] = SbVec3f(V1.X(), V1.Y(), V1.Z());
-                verts[idx2] = SbVec3f(V2.X(), V2.Y(), V2.Z());
-                verts[idx3] = SbVec3f(V3.X(), V3.Y(), V3.Z());
-                
-                // Accumulate normals
-                norms[idx1] += SbVec3f(triangleNormal.X(), triangleNormal.Y(), triangleNormal.Z());
-                norms[idx2] += SbVec3f(triangleNormal.X(), triangleNormal.Y(), triangleNormal.Z());
-                norms[idx3] += SbVec3f(triangleNormal.X(), triangleNormal.Y(), triangleNormal.Z());
-                
-                // Set face index
-                int triIndex = faceTriaOffset * 4;
-                index[triIndex] = idx1;
-                index[triIndex + 1] = idx2;
-                index[triIndex + 2] = idx3;
-                index[triIndex + 3] = SO_END_FACE_INDEX;
-            }
-            
-            // Update offsets
-            faceNodeOffset += nbNodesInFace;
-            faceTriaOffset += nbTriInFace;
-        }
-        
-        // Normalize all normals
-        for (int i = 0; i < numNorms; i++) {
-            if (norms[i].sqrLength() > 1e-12) {
-                norms[i].normalize();
-            } else {
-                norms[i] = SbVec3f(0.0f, 0.0f, 1.0f);
-            }
-        }
-        
-        // Process edges (third pass)
-        std::vector<int32_t> lineSetCoords;
-        int edgeNodeOffset = faceNodeOffset;
-        
-        for (int i = 1; i <= edgeMap.Extent(); i++) {
-            const TopoDS_Edge& aEdge = TopoDS::Edge(edgeMap(i));
-            
-            Standard_Real first, last;
-            Handle(Geom_Curve) curve = BRep_Tool::Curve(aEdge, first, last);
-            
-            if (!curve.IsNull()) {
-                GeomAdaptor_Curve curveAdaptor(curve);
-                GCPnts_TangentialDeflection discretizer;
-                discretizer.Initialize(curveAdaptor, 0.05, 0.05, first, last);
-                
-                if (discretizer.NbPoints() > 0) {
-                    // Store edge vertices
-                    for (Standard_Integer j = 1; j <= discretizer.NbPoints(); j++) {
-                        gp_Pnt pnt = discretizer.Value(j);
-                        if (!aEdge.Location().IsIdentity()) {
-                            pnt.Transform(aEdge.Location().Transformation());
-                        }
-                        
-                        int nodeIndex = edgeNodeOffset++;
-                        verts[nodeIndex] = SbVec3f(pnt.X(), pnt.Y(), pnt.Z());
-                        lineSetCoords.push_back(nodeIndex);
-                    }
-                    lineSetCoords.push_back(-1); // End marker
-                }
-            }
-        }
-        
-        // Set line set coordinates
-        lineSet->coordIndex.setNum(lineSetCoords.size());
-        int32_t* lines = lineSet->coordIndex.startEditing();
-        
-        for (size_t i = 0; i < lineSetCoords.size(); i++) {
-            lines[i] = lineSetCoords[i];
-        }
-        
-        // Finish editing all nodes
-        coords->point.finishEditing();
-        norm->vector.finishEditing();
-        faceSet->coordIndex.finishEditing();
-        lineSet->coordIndex.finishEditing();
-        
-        // Add material for better visualization
-        SoMaterial* material = new SoMaterial;
-        material->diffuseColor.setValue(0.8, 0.8, 0.8);
-        material->specularColor.setValue(1.0, 1.0, 1.0);
-        material->shininess.setValue(0.5);
-        
-        // Assemble the scene graph
-        shapeSep->addChild(material);
-        shapeSep->addChild(normalBinding);
-        shapeSep->addChild(norm);
-        shapeSep->addChild(coords);
-        shapeSep->addChild(faceSet);
-        shapeSep->addChild(lineSet);
-        
-        return shapeSep;
-    } catch (const Standard_Failure& e) {
-        QMessageBox::critical(this, "OCCT Exception", e.GetMessageString());
-        return nullptr;
-    } catch (...) {
-        QMessageBox::critical(this, "Error", "Unknown error during shape conversion");
-        return nullptr;
-    }
-}
 
-bool TextOnCylinderForm::displayShape(const TopoDS_Shape& shape, bool clearExisting, SbColor color)
-{
-    // Clear existing model if requested
-    if (clearExisting) {
-        clearScene();
-    }
-    
-    // Convert OCCT shape to Coin3D node
-    SoNode* modelNode = convertShapeRecursive(shape, 0.001, 0.05, color);
-    if (modelNode) {
-        m_modelRoot->addChild(modelNode);
-        
         // Zoom to fit
         zoomAll();
-        
-        return true;
-    }
-    
-    return false;
+    };
+
+    m_converter->start({ displayed }, [color](const TopoDS_Shape& part) -> SoNode* {
+        ShapeUtil::meshShape(part, ViewTool::getDeflection(part, 0.001), 0.05);
+        return ShapeUtil::convertMeshedShape(part, color);
+    }, callbacks);
+
+    return true;
 }
 
 void TextOnCylinderForm::clearScene()
 {
+    // Shapes that are still being converted are dropped
+    m_converter->cancel();
+
     // Remove all children from model root
     while (m_modelRoot->getNumChildren() > 0) {
         m_modelRoot->removeChild(0);
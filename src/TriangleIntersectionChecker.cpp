@@ -0,0 +1,316 @@
+#include "TriangleIntersectionChecker.h"
+
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Precision.hxx>
+#include <TopExp.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+namespace {
+    // Maximum number of triangles in a leaf
+    const int LEAF_SIZE = 4;
+
+    // Triangles handled by one parallel task
+    const int TRIANGLES_PER_TASK = 2048;
+
+    // Parametric margin of the piercing test; keeps touching contacts out of the result
+    const double PARAM_EPSILON = 1.0e-9;
+}
+
+TriangleIntersectionChecker::TriangleIntersectionChecker()
+    : m_tolerance(Precision::Confusion())
+    , m_parallel(true)
+    , m_intersectingPairCount(0)
+    , m_elapsedSeconds(0.0)
+{
+}
+
+int TriangleIntersectionChecker::Load(const TopoDS_Shape& shape)
+{
+    m_faces.Clear();
+    m_triangles.clear();
+    m_facePairs.clear();
+    m_intersectingPairCount = 0;
+
+    if (shape.IsNull()) {
+        return 0;
+    }
+
+    TopExp::MapShapes(shape, TopAbs_FACE, m_faces);
+
+    const double minDoubleArea = m_tolerance * m_tolerance;
+    for (int f = 1; f <= m_faces.Extent(); f++) {
+        const TopoDS_Face& face = TopoDS::Face(m_faces(f));
+        TopLoc_Location location;
+        Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(face, location);
+        if (mesh.IsNull()) {
+            continue;
+        }
+
+        const gp_Trsf& transform = location.Transformation();
+        const bool identity = location.IsIdentity();
+
+        for (int t = 1; t <= mesh->NbTriangles(); t++) {
+            int n[3];
+            mesh->Triangle(t).Get(n[0], n[1], n[2]);
+
+            Triangle triangle;
+            triangle.face = f;
+            for (int k = 0; k < 3; k++) {
+                gp_Pnt node = mesh->Node(n[k]);
+                if (!identity) {
+                    node.Transform(transform);
+                }
+                triangle.nodes[k] = node.XYZ();
+            }
+
+            // Degenerate slivers have no interior to be pierced
+            gp_XYZ normal = (triangle.nodes[1] - triangle.nodes[0]).Crossed(triangle.nodes[2] - triangle.nodes[0]);
+            if (normal.Modulus() <= minDoubleArea) {
+                continue;
+            }
+            m_triangles.push_back(triangle);
+        }
+    }
+
+    return static_cast<int>(m_triangles.size());
+}
+
+bool TriangleIntersectionChecker::Perform()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    m_facePairs.clear();
+    m_intersectingPairCount = 0;
+    m_nodes.clear();
+
+    const int triangleCount = static_cast<int>(m_triangles.size());
+    if (triangleCount < 2) {
+        m_elapsedSeconds = 0.0;
+        return false;
+    }
+
+    // Boxes are inflated by the tolerance so near-coincident pairs still meet in the tree
+    m_boxes.resize(static_cast<size_t>(triangleCount) * 6);
+    for (int i = 0; i < triangleCount; i++) {
+        double* box = &m_boxes[static_cast<size_t>(i) * 6];
+        const Triangle& triangle = m_triangles[i];
+        for (int axis = 0; axis < 3; axis++) {
+            double a = triangle.nodes[0].Coord(axis + 1);
+            double b = triangle.nodes[1].Coord(axis + 1);
+            double c = triangle.nodes[2].Coord(axis + 1);
+            box[axis] = std::min(a, std::min(b, c)) - m_tolerance;
+            box[axis + 3] = std::max(a, std::max(b, c)) + m_tolerance;
+        }
+    }
+
+    m_order.resize(triangleCount);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    m_nodes.reserve(2 * (triangleCount / LEAF_SIZE + 1));
+    BuildNode(0, triangleCount);
+
+    // Each task keeps its own pair list; lists are merged once traversal is done
+    const int taskCount = (triangleCount + TRIANGLES_PER_TASK - 1) / TRIANGLES_PER_TASK;
+    std::vector<std::vector<std::pair<int, int>>> taskPairs(taskCount);
+    std::vector<int> taskHits(taskCount, 0);
+
+    OSD_Parallel::For(0, taskCount, [&](int task) {
+        std::vector<int> stack;
+        stack.reserve(64);
+        const int first = task * TRIANGLES_PER_TASK;
+        const int last = std::min(first + TRIANGLES_PER_TASK, triangleCount);
+        for (int i = first; i < last; i++) {
+            CollectPairs(i, stack, taskPairs[task], taskHits[task]);
+        }
+    }, !m_parallel);
+
+    for (int task = 0; task < taskCount; task++) {
+        m_facePairs.insert(m_facePairs.end(), taskPairs[task].begin(), taskPairs[task].end());
+        m_intersectingPairCount += taskHits[task];
+    }
+    std::sort(m_facePairs.begin(), m_facePairs.end());
+    m_facePairs.erase(std::unique(m_facePairs.begin(), m_facePairs.end()), m_facePairs.end());
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    m_elapsedSeconds = elapsed.count();
+
+    return !m_facePairs.empty();
+}
+
+int TriangleIntersectionChecker::BuildNode(int begin, int end)
+{
+    const int index = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(BvhNode());
+
+    double boxMin[3] = { RealLast(), RealLast(), RealLast() };
+    double boxMax[3] = { RealFirst(), RealFirst(), RealFirst() };
+    double centerMin[3] = { RealLast(), RealLast(), RealLast() };
+    double centerMax[3] = { RealFirst(), RealFirst(), RealFirst() };
+    for (int i = begin; i < end; i++) {
+        const double* box = &m_boxes[static_cast<size_t>(m_order[i]) * 6];
+        for (int axis = 0; axis < 3; axis++) {
+            boxMin[axis] = std::min(boxMin[axis], box[axis]);
+            boxMax[axis] = std::max(boxMax[axis], box[axis + 3]);
+            double center = box[axis] + box[axis + 3];
+            centerMin[axis] = std::min(centerMin[axis], center);
+            centerMax[axis] = std::max(centerMax[axis], center);
+        }
+    }
+
+    BvhNode node;
+    std::copy(boxMin, boxMin + 3, node.boxMin);
+    std::copy(boxMax, boxMax + 3, node.boxMax);
+    node.left = -1;
+    node.right = -1;
+    node.first = begin;
+    node.count = end - begin;
+
+    if (end - begin > LEAF_SIZE) {
+        // Median split along the longest axis of the centroid bounds
+        int axis = 0;
+        for (int a = 1; a < 3; a++) {
+            if (centerMax[a] - centerMin[a] > centerMax[axis] - centerMin[axis]) {
+                axis = a;
+            }
+        }
+
+        if (centerMax[axis] > centerMin[axis]) {
+            const int middle = begin + (end - begin) / 2;
+            std::nth_element(m_order.begin() + begin, m_order.begin() + middle, m_order.begin() + end,
+                [this, axis](int a, int b) {
+                    const double* boxA = &m_boxes[static_cast<size_t>(a) * 6];
+                    const double* boxB = &m_boxes[static_cast<size_t>(b) * 6];
+                    return boxA[axis] + boxA[axis + 3] < boxB[axis] + boxB[axis + 3];
+                });
+
+            node.count = 0;
+            m_nodes[index] = node;
+            int left = BuildNode(begin, middle);
+            int right = BuildNode(middle, end);
+            m_nodes[index].left = left;
+            m_nodes[index].right = right;
+            return index;
+        }
+    }
+
+    m_nodes[index] = node;
+    return index;
+}
+
+void TriangleIntersectionChecker::CollectPairs(int triangle, std::vector<int>& stack,
+    std::vector<std::pair<int, int>>& pairs, int& hits) const
+{
+    const double* box = &m_boxes[static_cast<size_t>(triangle) * 6];
+    const Triangle& current = m_triangles[triangle];
+
+    stack.clear();
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const BvhNode& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (box[0] > node.boxMax[0] || box[3] < node.boxMin[0] ||
+            box[1] > node.boxMax[1] || box[4] < node.boxMin[1] ||
+            box[2] > node.boxMax[2] || box[5] < node.boxMin[2]) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+
+        for (int k = node.first; k < node.first + node.count; k++) {
+            // Every unordered pair is tested once, by its lower triangle index
+            const int other = m_order[k];
+            if (other <= triangle) {
+                continue;
+            }
+
+            const double* otherBox = &m_boxes[static_cast<size_t>(other) * 6];
+            if (box[0] > otherBox[3] || box[3] < otherBox[0] ||
+                box[1] > otherBox[4] || box[4] < otherBox[1] ||
+                box[2] > otherBox[5] || box[5] < otherBox[2]) {
+                continue;
+            }
+
+            const Triangle& candidate = m_triangles[other];
+            if (Intersect(current, candidate)) {
+                pairs.push_back(std::make_pair(std::min(current.face, candidate.face),
+                    std::max(current.face, candidate.face)));
+                hits++;
+            }
+        }
+    }
+}
+
+bool TriangleIntersectionChecker::Intersect(const Triangle& a, const Triangle& b) const
+{
+    if (ShareVertex(a, b)) {
+        return false;
+    }
+
+    // Two non-coplanar triangles cross iff an edge of one pierces the other
+    for (int k = 0; k < 3; k++) {
+        if (SegmentPiercesTriangle(a.nodes[k], a.nodes[(k + 1) % 3], b) ||
+            SegmentPiercesTriangle(b.nodes[k], b.nodes[(k + 1) % 3], a)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TriangleIntersectionChecker::ShareVertex(const Triangle& a, const Triangle& b) const
+{
+    const double squareTolerance = m_tolerance * m_tolerance;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if ((a.nodes[i] - b.nodes[j]).SquareModulus() <= squareTolerance) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool TriangleIntersectionChecker::SegmentPiercesTriangle(const gp_XYZ& p0, const gp_XYZ& p1,
+    const Triangle& triangle) const
+{
+    // Moller-Trumbore restricted to the open segment and the open triangle
+    const gp_XYZ edge1 = triangle.nodes[1] - triangle.nodes[0];
+    const gp_XYZ edge2 = triangle.nodes[2] - triangle.nodes[0];
+    const gp_XYZ direction = p1 - p0;
+
+    const gp_XYZ h = direction.Crossed(edge2);
+    const double det = edge1.Dot(h);
+    const double scale = edge1.Modulus() * edge2.Modulus() * direction.Modulus();
+    if (std::abs(det) <= PARAM_EPSILON * scale) {
+        return false; // Parallel or coplanar
+    }
+
+    const double invDet = 1.0 / det;
+    const gp_XYZ s = p0 - triangle.nodes[0];
+    const double u = invDet * s.Dot(h);
+    if (u <= PARAM_EPSILON || u >= 1.0 - PARAM_EPSILON) {
+        return false;
+    }
+
+    const gp_XYZ q = s.Crossed(edge1);
+    const double v = invDet * direction.Dot(q);
+    if (v <= PARAM_EPSILON || u + v >= 1.0 - PARAM_EPSILON) {
+        return false;
+    }
+
+    const double t = invDet * edge2.Dot(q);
+    return t > PARAM_EPSILON && t < 1.0 - PARAM_EPSILON;
+}